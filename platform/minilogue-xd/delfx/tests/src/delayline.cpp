@@ -3,7 +3,9 @@
  *
  * Test SDRAM memory i/o for delay lines
  *
- * 
+ * Writes go through an on-chip staging buffer flushed to SDRAM once per chunk. Build with UDEFS = -DBENCH to
+ * record processing cycles in s_bench, read from a debugger, add -DBENCH_UNSTAGED to compare with direct SDRAM
+ * writes.
  * 
  * 2018 (c) Korg
  *
@@ -13,44 +15,88 @@
 
 #include "delayline.hpp"
 
+enum {
+  k_stage_size = 64
+};
+
 static dsp::DelayLine s_delay;
 
 static __sdram float s_delay_ram[48000];
+static float s_stage_ram[k_stage_size];
 
-static float s_len_z, s_len;
+static float s_len;
 static float s_mix;
 static const float s_fs_recip = 1.f / 48000.f;
 
+#ifdef BENCH
+typedef struct Bench {
+  uint32_t last;     // Cycles spent processing last buffer
+  uint32_t max;      // Worst case since init
+  uint32_t frames;   // Frames in last buffer
+} Bench;
+
+static volatile Bench s_bench;
+#endif
+
 void DELFX_INIT(uint32_t platform, uint32_t api)
 {
   s_delay.setMemory(s_delay_ram, 48000);  
-  s_len = s_len_z = 1.f;
+#ifndef BENCH_UNSTAGED
+  s_delay.setStage(s_stage_ram, k_stage_size);
+#endif
+  s_delay.setXfadeLength(2400); // 50ms
+  s_len = 1.f;
   s_mix = 1.f;
+#ifdef BENCH
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  s_bench.last = s_bench.max = s_bench.frames = 0;
+#endif
 }
 
 void DELFX_PROCESS(float *xn, uint32_t frames)
 {
+#ifdef BENCH
+  const uint32_t t0 = DWT->CYCCNT;
+#endif
+  
   float * __restrict x = xn;
   const float * x_e = x + 2*frames;
   
-  const float len = s_len;
-  float len_z = s_len_z;
+  s_delay.updateXfade(s_len, frames);
 
   const float dry = 1.f - s_mix;
   const float wet = s_mix;
   
   for (; x != x_e; ) {
+    // Staging buffer holds at most one chunk of writes
+    const uint32_t remaining = (x_e - x) >> 1;
+    const uint32_t count = (remaining < k_stage_size) ? remaining : k_stage_size;
+    const float * xc_e = x + 2*count;
     
-    *(x++); // leave left channel un-delayed for comparitive earing
-    
-    len_z = linintf(0.00004f, len_z, len);
+    for (; x != xc_e; x += 2) {
+      // leave left channel un-delayed for comparitive earing
+      const float r = 0.25f * s_delay.readXfade();
+#ifdef BENCH_UNSTAGED
+      s_delay.write(x[1]);
+#else
+      s_delay.writeStaged(x[1]);
+#endif
+      x[1] = dry * x[1] + wet * r;
+    }
     
-    const float r = 0.25f * s_delay.readFrac(len_z);
-    s_delay.write(*x);
-    *(x++) = dry * (*x) + wet * r;
+#ifndef BENCH_UNSTAGED
+    s_delay.flushStage();
+#endif
   }
 
-  s_len_z = len_z;
+#ifdef BENCH
+  const uint32_t cycles = DWT->CYCCNT - t0;
+  s_bench.last = cycles;
+  s_bench.max = (cycles > s_bench.max) ? cycles : s_bench.max;
+  s_bench.frames = frames;
+#endif
 }
 
 
@@ -43,6 +43,10 @@
 
 static Waves s_waves;
 
+enum {
+  k_block_size = 64
+};
+
 void OSC_INIT(uint32_t platform, uint32_t api)
 {
   (void)platform;
@@ -62,7 +66,9 @@ void OSC_CYCLE(const user_osc_param_t * const params,
     const uint32_t flags = s.flags;
     s.flags = Waves::k_flags_none;
     
-    s_waves.updatePitch(osc_w0f_for_note((params->pitch)>>8, params->pitch & 0xFF));
+    // Pitch is only converted when it changes
+    osc_pitch_update(&s.pitch, params->pitch);
+    s_waves.updatePitch(s.pitch.w0f);
     
     s_waves.updateWaves(flags);
     
@@ -79,9 +85,9 @@ void OSC_CYCLE(const user_osc_param_t * const params,
   }
   
   // Temporaries.
-  float phi0 = s.phi0;
-  float phi1 = s.phi1;
-  float phisub = s.phisub;
+  uint32_t phi0 = s.phi0;
+  uint32_t phi1 = s.phi1;
+  uint32_t phisub = s.phisub;
 
   float lfoz = s.lfoz;
   const float lfo_inc = (s.lfo - lfoz) / frames;
@@ -99,34 +105,43 @@ void OSC_CYCLE(const user_osc_param_t * const params,
   
   q31_t * __restrict y = (q31_t *)yn;
   const q31_t * y_e = y + frames;
+
+  float wave_buf[k_block_size];
+  float sub_buf[k_block_size];
+  float dither_buf[k_block_size];
   
   for (; y != y_e; ) {
-
-    const float wavemix = clipminmaxf(0.005f, p.shape+lfoz, 0.995f);
-    
-    float sig = (1.f - wavemix) * osc_wave_scanf(s.wave0, phi0);
-    sig += wavemix * osc_wave_scanf(s.wave1, phi1);
-    
-    const float subsig = osc_wave_scanf(s.subwave, phisub);
-    sig = (1.f - submix) * sig + submix * subsig;
-    sig = (1.f - ringmix) * sig + ringmix * (subsig * sig);
-    sig = clip1m1f(sig);
-    
-    sig = prelpf.process_fo(sig);
-    sig += s.dither * osc_white();
-    sig = si_roundf(sig * s.bitres) * s.bitresrcp;
-    sig = postlpf.process_fo(sig);
-    sig = osc_softclipf(0.125f, sig);
-    
-    *(y++) = f32_to_q31(sig);
-    
-    phi0 += s.w00;
-    phi0 -= (uint32_t)phi0;
-    phi1 += s.w01;
-    phi1 -= (uint32_t)phi1;
-    phisub += s.w0sub;
-    phisub -= (uint32_t)phisub;
-    lfoz += lfo_inc;
+    const uint32_t remaining = y_e - y;
+    const uint32_t count = (remaining < k_block_size) ? remaining : k_block_size;
+
+    // Scan oscillators for the whole chunk, wave mix ramps along with the LFO.
+    const float wavemix0 = clipminmaxf(0.005f, p.shape+lfoz, 0.995f);
+    lfoz += lfo_inc * count;
+    const float wavemix1 = clipminmaxf(0.005f, p.shape+lfoz, 0.995f);
+    
+    osc_wave_xfade_scanuf_buf(wave_buf, count, s.wave0, s.wave1, &phi0, &phi1, s.w00, s.w01, wavemix0, wavemix1);
+    phisub = osc_wave_scanuf_buf(sub_buf, count, s.subwave, phisub, s.w0sub, s.w0sub);
+    s.noise.white(dither_buf, count, s.dither);
+
+    const float *w = wave_buf;
+    const float *sw = sub_buf;
+    const float *d = dither_buf;
+    const q31_t *yc_e = y + count;
+    for (; y != yc_e; ) {
+      float sig = *(w++);
+      const float subsig = *(sw++);
+      sig = (1.f - submix) * sig + submix * subsig;
+      sig = (1.f - ringmix) * sig + ringmix * (subsig * sig);
+      sig = clip1m1f(sig);
+    
+      sig = prelpf.process_fo(sig);
+      sig += *(d++);
+      sig = si_roundf(sig * s.bitres) * s.bitresrcp;
+      sig = postlpf.process_fo(sig);
+      sig = osc_softclipf(0.125f, sig);
+    
+      *(y++) = f32_to_q31(sig);
+    }
   }
   
   s.phi0 = phi0;
@@ -154,21 +169,15 @@ void OSC_PARAM(uint16_t index, uint16_t value)
   case k_user_osc_param_id1:
     // wave 0
     // select parameter
-    {
-      static const uint8_t cnt = k_waves_a_cnt + k_waves_b_cnt + k_waves_c_cnt; 
-      p.wave0 = value % cnt;
-      s.flags |= Waves::k_flag_wave0;
-    }
+    p.wave0 = value % (k_waves_d_ofs - k_waves_a_ofs);
+    s.flags |= Waves::k_flag_wave0;
     break;
     
   case k_user_osc_param_id2:
     // wave 1
     // select parameter
-    {
-      static const uint8_t cnt = k_waves_d_cnt + k_waves_e_cnt + k_waves_f_cnt; 
-      p.wave1 = value % cnt;
-      s.flags |= Waves::k_flag_wave1;
-    }
+    p.wave1 = value % (k_waves_cnt - k_waves_d_ofs);
+    s.flags |= Waves::k_flag_wave1;
     break;
     
   case k_user_osc_param_id3:
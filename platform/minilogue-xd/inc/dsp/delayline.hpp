@@ -71,8 +71,14 @@ namespace dsp {
       mFracZ(0),
       mSize(0),
       mMask(0),
-      mWriteIdx(0)
-    { }
+      mWriteIdx(0),
+      mXfadeRate(1.f / 2048),
+      mStage(0),
+      mStageSize(0),
+      mStageHead(0)
+    {
+      resetXfade();
+    }
 
     /**
      * Constructor with explicit memory area to use as backing buffer for delay line.
@@ -86,8 +92,14 @@ namespace dsp {
       mFracZ(0),
       mSize(line_size),
       mMask(line_size-1),
-      mWriteIdx(0)
-    { }
+      mWriteIdx(0),
+      mXfadeRate(1.f / 2048),
+      mStage(0),
+      mStageSize(0),
+      mStageHead(0)
+    {
+      resetXfade();
+    }
       
     /*===========================================================================*/
     /* Public Methods.                                                           */
@@ -115,6 +127,7 @@ namespace dsp {
       mSize = nextpow2_u32(line_size); // must be power of 2
       mMask = (mSize-1);
       mWriteIdx = 0;
+      mStageHead = 0;
     }
 
     /**
@@ -167,7 +180,195 @@ namespace dsp {
       mFracZ = s0;
       return y;
     }
+
+    // --- Staged writes --------------
+
+    /**
+     * Set the memory area to use as write staging buffer.
+     *
+     * Staged writes are accumulated in this buffer and copied to the delay line memory in a single
+     * burst by flushStage(). Intended for delay lines in SDRAM, with the staging buffer in on-chip SRAM.
+     *
+     * @param ram Pointer to memory buffer
+     * @param stage_size Size in float of memory buffer, typically the maximum block size.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setStage(float *ram, size_t stage_size) {
+      mStage = ram;
+      mStageSize = stage_size;
+      mStageHead = mWriteIdx;
+    }
+
+    /**
+     * Write a single sample to the staging buffer.
+     *
+     * @param s Sample to write
+     * @note Not checking bounds, caller responsible for calling flushStage() at least once every staging buffer size writes.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void writeStaged(const float s) {
+      // Stored in reverse order so that flushing is a forward copy
+      mStage[mStageSize - 1 - (mStageHead - (mWriteIdx--))] = s;
+    }
+
+    /**
+     * Read a single sample at given position from current write index, including staged samples.
+     *
+     * @param pos Offset from write index
+     * @return Sample at given position from write index
+     * @note Reads of samples written since last flush are served from the staging buffer.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float readStaged(const uint32_t pos) {
+      const uint32_t staged = mStageHead - mWriteIdx;
+      if ((pos - 1) < staged)
+        return mStage[mStageSize - 1 - staged + pos];
+      return mLine[(mWriteIdx + pos) & mMask];
+    }
+
+    /**
+     * Read a sample at a fractional position from current write index, including staged samples.
+     *
+     * @param pos Offset from write index as floating point.
+     * @return Interpolated sample at given fractional position from write index
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float readStagedFrac(const float pos) {
+      const uint32_t base = (uint32_t)pos;
+      const float frac = pos - base;
+      const float s0 = readStaged(base);
+      const float s1 = readStaged(base+1);
+      return linintf(frac, s0, s1);
+    }
+
+    /**
+     * Copy staged samples to delay line memory.
+     *
+     * @note Should be called once at the end of each block.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void flushStage(void) {
+      const uint32_t staged = mStageHead - mWriteIdx;
+      const float *src = mStage + mStageSize - staged;
+      const uint32_t start = (mWriteIdx + 1) & mMask;
+      const uint32_t len0 = (staged < mSize - start) ? staged : mSize - start;
+      buf_cpy_f32(src, mLine + start, len0);
+      buf_cpy_f32(src + len0, mLine, staged - len0);
+      mStageHead = mWriteIdx;
+    }
+
+    // --- Dual read-head crossfade --------------
+
+    /**
+     * Reset dual read-head state. Both heads are placed at the write index and no crossfade is pending.
+     *
+     * @note Does not change crossfade length.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void resetXfade(void) {
+      mHeadPos = 0.f;
+      mHeadBase[0] = mHeadBase[1] = 0;
+      mHeadFrac[0] = mHeadFrac[1] = 0.f;
+      mHeadGain[0] = 1.f;
+      mHeadGain[1] = 0.f;
+      mHeadGainInc[0] = mHeadGainInc[1] = 0.f;
+      mXfadePhase = 1.f;
+      mXfading = 0;
+    }
+
+    /**
+     * Set the length of the crossfade applied when dual read-head delay time changes.
+     *
+     * @param len Crossfade length in samples, 2048 by default
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setXfadeLength(const float len) {
+      mXfadeRate = 1.f / len;
+    }
+
+    /**
+     * Retarget dual read-head delay time. Must be called once per block, before calls to readXfade().
+     *
+     * When no crossfade is in progress and the requested position differs from the current read head,
+     * the current head starts fading out and a new head is placed at the requested position.
+     * Equal-power gains are computed at block boundaries and ramped linearly within the block,
+     * so the per sample cost does not depend on how delay time is modulated.
+     *
+     * @param pos Offset from write index as floating point.
+     * @param frames Number of reads until next call.
+     *
+     * @note Retargeting during a crossfade takes effect once the current crossfade completes. Ignored if frames is 0.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void updateXfade(const float pos, const uint32_t frames) {
+      if (!frames)
+        return;
+      
+      float phase = mXfadePhase;
+      
+      if (phase >= 1.f) {
+        if (pos == mHeadPos) {
+          mHeadGain[0] = 1.f;
+          mHeadGain[1] = 0.f;
+          mXfading = 0;
+          return;
+        }
+        // Swap heads, new head fades in from current position
+        mHeadBase[1] = mHeadBase[0];
+        mHeadFrac[1] = mHeadFrac[0];
+        mHeadPos = pos;
+        mHeadBase[0] = (uint32_t)pos;
+        mHeadFrac[0] = pos - mHeadBase[0];
+        phase = 0.f;
+      }
+
+      const float phase_e = clip1f(phase + frames * mXfadeRate);
+      const float frames_recip = 1.f / frames;
       
+      // Equal-power gains, ends forced to exact unity/zero to avoid level step after crossfade
+      const float g0 = (phase_e >= 1.f) ? 1.f : fastsinf(M_PI_2 * phase_e);
+      const float g1 = (phase_e >= 1.f) ? 0.f : fastsinf(M_PI_2 * (1.f - phase_e));
+      
+      mHeadGain[0] = (phase <= 0.f) ? 0.f : fastsinf(M_PI_2 * phase);
+      mHeadGain[1] = (phase <= 0.f) ? 1.f : fastsinf(M_PI_2 * (1.f - phase));
+      mHeadGainInc[0] = (g0 - mHeadGain[0]) * frames_recip;
+      mHeadGainInc[1] = (g1 - mHeadGain[1]) * frames_recip;
+      
+      mXfadePhase = phase_e;
+      mXfading = 1;
+    }
+
+    /**
+     * Read a sample from the dual read-head delay line, crossfading heads if needed.
+     *
+     * @return Interpolated sample at current delay time.
+     * @note Delay time is set via updateXfade(). When a staging buffer is set, reads include staged samples, see
+     *       readStaged().
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float readXfade(void) {
+      const float y0 = linintf(mHeadFrac[0], readTap(mHeadBase[0]), readTap(mHeadBase[0]+1));
+      if (!mXfading)
+        return y0;
+      
+      const float y1 = linintf(mHeadFrac[1], readTap(mHeadBase[1]), readTap(mHeadBase[1]+1));
+      const float y = mHeadGain[0] * y0 + mHeadGain[1] * y1;
+      mHeadGain[0] += mHeadGainInc[0];
+      mHeadGain[1] += mHeadGainInc[1];
+      return y;
+    }
+      
+    /*===========================================================================*/
+    /* Private Methods.                                                          */
+    /*===========================================================================*/
+
+    /**
+     * Read through the staging buffer if one is set, so that dual read-head reads see samples not yet flushed.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float readTap(const uint32_t pos) {
+      return (mStage) ? readStaged(pos) : read(pos);
+    }
       
     /*===========================================================================*/
     /* Member Variables.                                                         */
@@ -178,6 +379,21 @@ namespace dsp {
     size_t   mSize;
     size_t   mMask;
     uint32_t mWriteIdx;
+
+    // Dual read-head crossfade state
+    float    mHeadPos;
+    uint32_t mHeadBase[2];
+    float    mHeadFrac[2];
+    float    mHeadGain[2];
+    float    mHeadGainInc[2];
+    float    mXfadePhase;
+    float    mXfadeRate;
+    uint8_t  mXfading;
+
+    // Write staging state
+    float   *mStage;
+    size_t   mStageSize;
+    uint32_t mStageHead;
       
   };
 
@@ -0,0 +1,221 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+
+#include "fixed_math.h"
+#include "float_math.h"
+
+/**
+ * @file    fmpair.hpp
+ * @brief   Two operator FM kernel.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ */
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Modulator/carrier operator pair with modulator self-feedback, in serial (modulator drives carrier phase) or
+   * parallel (carrier plus ring modulated modulator) route.
+   *
+   * Phases are 32-bit integers, full cycle over 2^32. Modulator output and feedback are kept in Q24 (in cycles), so
+   * phase modulation amounts to a shift and an integer add, and wrap around is implicit. The modulator gain is
+   * ramped in Q24 across the block.
+   *
+   * Waveforms are provided by W, any type providing:
+   *
+   *   template<uint8_t wave> static float lookup(const uint32_t phi)
+   *
+   * for wave in [0, k_wave_count), e.g.: wrapping osc_sinuf(), osc_sawuf(), osc_sqruf() and osc_paruf().
+   *
+   * All waveform and route combinations are instantiated, renderFunc() selects one once per block.
+   *
+   * @tparam W Waveform lookups.
+   */
+  template<typename W>
+  struct FMPair {
+
+    /*===========================================================================*/
+    /* Types and Data Structures.                                                */
+    /*===========================================================================*/
+
+    enum {
+      k_wave_count = 4
+    };
+
+    /**
+     * Block render method, as returned by renderFunc().
+     */
+    typedef void (FMPair::*RenderFunc)(q31_t * __restrict, const uint32_t, const uint32_t, const uint32_t, int32_t, const int32_t);
+    
+    /*===========================================================================*/
+    /* Constructor / Destructor.                                                 */
+    /*===========================================================================*/
+
+    /**
+     * Default constructor
+     */
+    FMPair(void) :
+      fb_shift(16)
+    {
+      reset();
+    }
+    
+    /*===========================================================================*/
+    /* Public Methods.                                                           */
+    /*===========================================================================*/
+
+    /**
+     * Reset phases and feedback
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void reset(void)
+    {
+      phi0 = phi1 = 0;
+      fb0 = fb1 = 0;
+    }
+
+    /**
+     * Set modulator self-feedback amount.
+     *
+     * @param shift Right shift applied to the sum of the last two modulator outputs, 16 or more for no audible feedback.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setFeedbackShift(const uint8_t shift)
+    {
+      fb_shift = shift;
+    }
+
+    /**
+     * Render a block of samples, overwriting output.
+     *
+     * Operators are mixed at 0.25 each to leave headroom.
+     *
+     * @tparam car    Carrier waveform.
+     * @tparam mod    Modulator waveform.
+     * @tparam serial True for serial route, false for parallel route.
+     * @param  out    Output buffer.
+     * @param  n      Number of samples to render.
+     * @param  w0     Carrier phase increment, full cycle over 2^32.
+     * @param  w1     Modulator phase increment, full cycle over 2^32.
+     * @param  gain   Modulator gain at start of block, in Q24.
+     * @param  dgain  Per sample modulator gain increment, in Q24.
+     */
+    template<uint8_t car, uint8_t mod, bool serial>
+    inline __attribute__((optimize("Ofast")))
+    void render(q31_t * __restrict out, const uint32_t n, const uint32_t w0, const uint32_t w1,
+                int32_t gain, const int32_t dgain)
+    {
+      const float q24 = (float)(1 << 24);
+      const float q24recip = 1.f / q24;
+      const uint8_t shift = fb_shift + 1;
+      
+      uint32_t p0 = phi0;
+      uint32_t p1 = phi1;
+      int32_t y0 = fb0;
+      int32_t y1 = fb1;
+      
+      for (uint32_t i = 0; i < n; ++i) {
+        gain += dgain;
+        const int32_t fb = (y0 + y1) >> shift;
+        y0 = y1;
+        const float m = W::template lookup<mod>(p1 + ((uint32_t)fb << 8)) * (gain * q24recip);
+        y1 = (int32_t)(m * q24);
+        
+        float sig;
+        if (serial)
+          sig = 0.25f * W::template lookup<car>(p0 + ((uint32_t)y1 << 8));
+        else
+          sig = 0.25f * (W::template lookup<car>(p0) + W::template lookup<mod>(p1) * m);
+        out[i] = f32_to_q31(sig);
+        
+        p0 += w0;
+        p1 += w1;
+      }
+      
+      phi0 = p0;
+      phi1 = p1;
+      fb0 = y0;
+      fb1 = y1;
+    }
+
+    /**
+     * Select block render method for given waveforms and route. Meant to be called once per block.
+     *
+     * @param car    Carrier waveform in [0, k_wave_count).
+     * @param mod    Modulator waveform in [0, k_wave_count).
+     * @param serial True for serial route, false for parallel route.
+     * @return       Pointer to member render method, to be invoked as (pair.*func)(out, n, w0, w1, gain, dgain).
+     */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    RenderFunc renderFunc(const uint8_t car, const uint8_t mod, const bool serial)
+    {
+      static const RenderFunc table[k_wave_count][k_wave_count][2] = {
+        { { &FMPair::render<0, 0, false>, &FMPair::render<0, 0, true> },
+          { &FMPair::render<0, 1, false>, &FMPair::render<0, 1, true> },
+          { &FMPair::render<0, 2, false>, &FMPair::render<0, 2, true> },
+          { &FMPair::render<0, 3, false>, &FMPair::render<0, 3, true> } },
+        { { &FMPair::render<1, 0, false>, &FMPair::render<1, 0, true> },
+          { &FMPair::render<1, 1, false>, &FMPair::render<1, 1, true> },
+          { &FMPair::render<1, 2, false>, &FMPair::render<1, 2, true> },
+          { &FMPair::render<1, 3, false>, &FMPair::render<1, 3, true> } },
+        { { &FMPair::render<2, 0, false>, &FMPair::render<2, 0, true> },
+          { &FMPair::render<2, 1, false>, &FMPair::render<2, 1, true> },
+          { &FMPair::render<2, 2, false>, &FMPair::render<2, 2, true> },
+          { &FMPair::render<2, 3, false>, &FMPair::render<2, 3, true> } },
+        { { &FMPair::render<3, 0, false>, &FMPair::render<3, 0, true> },
+          { &FMPair::render<3, 1, false>, &FMPair::render<3, 1, true> },
+          { &FMPair::render<3, 2, false>, &FMPair::render<3, 2, true> },
+          { &FMPair::render<3, 3, false>, &FMPair::render<3, 3, true> } }
+      };
+      return table[(car < k_wave_count) ? car : 0][(mod < k_wave_count) ? mod : 0][serial];
+    }
+    
+    /*===========================================================================*/
+    /* Members Vars                                                              */
+    /*===========================================================================*/
+
+    uint32_t phi0; // carrier phase
+    uint32_t phi1; // modulator phase
+    int32_t  fb0;  // last two modulator outputs, Q24
+    int32_t  fb1;
+    uint8_t  fb_shift;
+  };
+}
+
+/** @} */
@@ -0,0 +1,258 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+
+#include "float_math.h"
+
+/**
+ * @file    glide.hpp
+ * @brief   Portamento and vibrato on phase increments.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ */
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Portamento and vibrato engine.
+   *
+   * Glides are linear in log-frequency, i.e.: the phase increment is multiplied by a constant ratio every sample, and
+   * take the same time regardless of interval. Vibrato is applied as a ratio as well, ramped across each block from the
+   * LFO value given for the block. A block of increments is thus rendered with one multiply per sample, split in two
+   * segments when a glide ends within the block.
+   *
+   * Increments are given as 0-1 floats, e.g.: from osc_w0f_for_pitch(), and rendered as integers, full cycle over
+   * 2^32, for oscillator kernels to consume.
+   */
+  struct Glide {
+
+    /*===========================================================================*/
+    /* Constructor / Destructor.                                                 */
+    /*===========================================================================*/
+
+    /**
+     * Default constructor
+     */
+    Glide(void) :
+      mW(0.f), mTarget(0.f), mStep(0.f), mRatio(1.f), mRemain(0), mTime(0), mDepth(0.f), mVib(0.f)
+    { }
+    
+    /*===========================================================================*/
+    /* Public Methods.                                                           */
+    /*===========================================================================*/
+
+    /**
+     * Set glide time.
+     *
+     * @param time     Glide time in seconds, 0 to disable.
+     * @param fs       Sampling frequency.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setTime(const float time, const float fs)
+    {
+      mTime = (uint32_t)(time * fs);
+    }
+
+    /**
+     * Set vibrato depth.
+     *
+     * @param semitones Pitch deviation for LFO values of +/-1.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setVibratoDepth(const float semitones)
+    {
+      mDepth = semitones * (1.f / 12.f);
+    }
+
+    /**
+     * Jump to phase increment, cancelling any glide in progress.
+     *
+     * @param w Phase increment in [0, 0.5).
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void jump(const float w)
+    {
+      mW = mTarget = w;
+      mRemain = 0;
+    }
+
+    /**
+     * Glide to phase increment, e.g.: on note on. Jumps if glide is disabled or no increment was set yet.
+     *
+     * @param w Phase increment in [0, 0.5).
+     */
+    inline __attribute__((optimize("Ofast")))
+    void retarget(const float w)
+    {
+      if (!mTime || mW <= 0.f || w <= 0.f) {
+        jump(w);
+        return;
+      }
+      if (w == mTarget)
+        return;
+      mTarget = w;
+      mStep = fastlog2f(w / mW) / mTime;
+      mRatio = ratio(mStep);
+      mRemain = mTime;
+    }
+
+    /**
+     * Follow phase increment, e.g.: from params->pitch every block. Changes while a glide is in progress retarget it
+     * within the remaining glide time, other changes are immediate.
+     *
+     * @param w Phase increment in [0, 0.5).
+     */
+    inline __attribute__((optimize("Ofast")))
+    void follow(const float w)
+    {
+      if (w == mTarget)
+        return;
+      if (mRemain && mW > 0.f && w > 0.f) {
+        // Keep remaining glide time
+        mTarget = w;
+        mStep = fastlog2f(w / mW) / mRemain;
+        mRatio = ratio(mStep);
+      }
+      else
+        jump(w);
+    }
+
+    /**
+     * Current phase increment, without vibrato.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float current(void) const
+    {
+      return mW;
+    }
+
+    /**
+     * True while a glide is in progress.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    bool gliding(void) const
+    {
+      return mRemain != 0;
+    }
+
+    /**
+     * Render a block of phase increments.
+     *
+     * @param out Output buffer, phase increments, full cycle over 2^32.
+     * @param n   Number of samples to render.
+     * @param lfo Vibrato LFO value at end of block in [-1, 1], e.g.: from params->shape_lfo.
+     */
+    inline __attribute__((optimize("Ofast")))
+    void render(uint32_t * __restrict out, const uint32_t n, const float lfo)
+    {
+      const float v0 = mVib;
+      const float v1 = mVib = mDepth * lfo;
+      const float dv = (v1 - v0) / n;
+      const float rv = ratio(dv);
+      
+      float x = mW * vibrato(v0) * 4294967296.f;
+      uint32_t i = 0;
+      
+      if (mRemain) {
+        const uint32_t n1 = (n < mRemain) ? n : mRemain;
+        const float r = mRatio * rv;
+        for (; i < n1; ++i) {
+          out[i] = (uint32_t)x;
+          x *= r;
+        }
+        mRemain -= n1;
+        if (mRemain) {
+          mW = mTarget * pow2(-mStep * mRemain);
+          return;
+        }
+        // Glide over, restart from exact target for remaining samples
+        mW = mTarget;
+        x = mW * vibrato(v0 + dv * n1) * 4294967296.f;
+      }
+      
+      for (; i < n; ++i) {
+        out[i] = (uint32_t)x;
+        x *= rv;
+      }
+    }
+
+    /*===========================================================================*/
+    /* Private Methods.                                                          */
+    /*===========================================================================*/
+
+    /**
+     * 2^x for small x, as used for per sample ratios.
+     */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float ratio(const float x)
+    {
+      const float a = 0.69314718f * x;
+      return 1.f + a * (1.f + a * (0.5f + a * 0.16666667f));
+    }
+
+    /**
+     * 2^x, once per block. fastpow2f() is only accurate for negative arguments, positive ones are mirrored.
+     */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float pow2(const float x)
+    {
+      return (x < 0.f) ? fastpow2f(x) : 1.f / fastpow2f(-x);
+    }
+
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float vibrato(const float v)
+    {
+      return (v != 0.f) ? pow2(v) : 1.f;
+    }
+    
+    /*===========================================================================*/
+    /* Members Vars                                                              */
+    /*===========================================================================*/
+
+    float    mW;      // current phase increment, without vibrato
+    float    mTarget; // glide target phase increment
+    float    mStep;   // glide step, octaves per sample
+    float    mRatio;  // glide step, ratio per sample
+    uint32_t mRemain; // samples left to glide
+    uint32_t mTime;   // glide time in samples
+    float    mDepth;  // vibrato depth, octaves
+    float    mVib;    // vibrato at end of last block, octaves
+  };
+}
+
+/** @} */
@@ -0,0 +1,248 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+
+#include <stdint.h>
+
+/**
+ * @file    noise.hpp
+ * @brief   Block noise generator.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ */
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Inline noise generator filling whole blocks, as a cheaper alternative to calling osc_white() or fx_white() once per
+   * sample.
+   *
+   * Four interleaved xorshift32 generators are advanced side by side, which has no dependency between consecutive
+   * samples and vectorizes on the host. Provides uniform white noise, pink noise (white noise through Paul Kellet's
+   * three pole economy filter, within about 0.5dB of -3dB/octave above 10Hz) and triangular PDF dither.
+   */
+  struct Noise {
+
+    /*===========================================================================*/
+    /* Types and Data Structures.                                                */
+    /*===========================================================================*/
+
+    enum {
+      k_lanes = 4
+    };
+
+    /*===========================================================================*/
+    /* Constructor / Destructor.                                                 */
+    /*===========================================================================*/
+
+    /**
+     * Default constructor
+     */
+    Noise(void)
+    {
+      seed(0);
+    }
+
+    /**
+     * Constructor with explicit seed.
+     *
+     * @param s Seed, e.g.: osc_rand() or osc_mcu_hash().
+     */
+    Noise(const uint32_t s)
+    {
+      seed(s);
+    }
+    
+    /*===========================================================================*/
+    /* Public Methods.                                                           */
+    /*===========================================================================*/
+
+    /**
+     * Reseed generators and clear pink filter.
+     *
+     * @param s Seed, e.g.: osc_rand() or osc_mcu_hash().
+     */
+    inline __attribute__((optimize("Ofast")))
+    void seed(uint32_t s)
+    {
+      for (uint32_t l = 0; l < k_lanes; ++l) {
+        // splitmix32 style scrambling, so that close seeds give unrelated lanes
+        s += 0x9E3779B9U;
+        uint32_t z = s;
+        z = (z ^ (z >> 16)) * 0x85EBCA6BU;
+        z = (z ^ (z >> 13)) * 0xC2B2AE35U;
+        z ^= z >> 16;
+        mState[l] = z ? z : 0x6D2B79F5U; // xorshift state must be non zero
+      }
+      mPink[0] = mPink[1] = mPink[2] = 0.f;
+    }
+
+    /**
+     * Fill buffer with uniform white noise.
+     *
+     * @param out Output buffer.
+     * @param n   Number of samples.
+     * @param amp Amplitude, samples in [-amp, amp).
+     */
+    inline __attribute__((optimize("Ofast")))
+    void white(float * __restrict out, const uint32_t n, const float amp = 1.f)
+    {
+      const float k = amp * (1.f / 2147483648.f);
+      uint32_t i = 0;
+      for (const uint32_t n4 = n & ~(k_lanes - 1); i < n4; i += k_lanes)
+        for (uint32_t l = 0; l < k_lanes; ++l)
+          out[i + l] = (int32_t)next(mState[l]) * k;
+      for (uint32_t l = 0; i < n; ++i, ++l)
+        out[i] = (int32_t)next(mState[l]) * k;
+    }
+
+    /**
+     * Fill buffer with pink noise.
+     *
+     * @param out Output buffer.
+     * @param n   Number of samples.
+     * @param amp Amplitude, RMS matched to white noise of the same amplitude, peaks may exceed it.
+     */
+    inline __attribute__((optimize("Ofast")))
+    void pink(float * __restrict out, const uint32_t n, const float amp = 1.f)
+    {
+      white(out, n, amp);
+      filterPink(out, out, n);
+    }
+
+    /**
+     * Fill buffer with triangular PDF dither, the sum of two independent uniform values.
+     *
+     * @param out Output buffer.
+     * @param n   Number of samples.
+     * @param amp Peak amplitude, typically one quantization step, samples in (-amp, amp).
+     */
+    inline __attribute__((optimize("Ofast")))
+    void tpdf(float * __restrict out, const uint32_t n, const float amp)
+    {
+      const float k = amp * (1.f / 32768.f);
+      uint32_t i = 0;
+      for (const uint32_t n4 = n & ~(k_lanes - 1); i < n4; i += k_lanes)
+        for (uint32_t l = 0; l < k_lanes; ++l)
+          out[i + l] = triangular(next(mState[l])) * k;
+      for (uint32_t l = 0; i < n; ++i, ++l)
+        out[i] = triangular(next(mState[l])) * k;
+    }
+
+    /**
+     * Fill white, pink and triangular PDF dither buffers in a single pass. Pink noise is the white buffer filtered,
+     * dither is drawn independently.
+     *
+     * @param white    White noise output buffer, samples in [-1, 1).
+     * @param pink     Pink noise output buffer.
+     * @param tpdf     Dither output buffer.
+     * @param n        Number of samples.
+     * @param tpdf_amp Peak dither amplitude.
+     */
+    inline __attribute__((optimize("Ofast")))
+    void fill(float * __restrict white, float * __restrict pink, float * __restrict tpdf,
+              const uint32_t n, const float tpdf_amp)
+    {
+      const float kw = 1.f / 2147483648.f;
+      const float kt = tpdf_amp * (1.f / 32768.f);
+      uint32_t i = 0;
+      for (const uint32_t n4 = n & ~(k_lanes - 1); i < n4; i += k_lanes)
+        for (uint32_t l = 0; l < k_lanes; ++l) {
+          white[i + l] = (int32_t)next(mState[l]) * kw;
+          tpdf[i + l] = triangular(next(mState[l])) * kt;
+        }
+      for (uint32_t l = 0; i < n; ++i, ++l) {
+        white[i] = (int32_t)next(mState[l]) * kw;
+        tpdf[i] = triangular(next(mState[l])) * kt;
+      }
+      filterPink(pink, white, n);
+    }
+
+    /*===========================================================================*/
+    /* Private Methods.                                                          */
+    /*===========================================================================*/
+
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    uint32_t next(uint32_t &x)
+    {
+      x ^= x << 13;
+      x ^= x >> 17;
+      x ^= x << 5;
+      return x;
+    }
+
+    /**
+     * Sum of the two signed 16-bit halves of x, in (-2^16, 2^16) with a triangular distribution, as float scaled by 1/2.
+     */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float triangular(const uint32_t x)
+    {
+      return 0.5f * (float)((int32_t)(int16_t)(x >> 16) + (int32_t)(int16_t)x);
+    }
+
+    /**
+     * Pink filter, out may be the same buffer as in.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void filterPink(float *out, const float *in, const uint32_t n)
+    {
+      float b0 = mPink[0];
+      float b1 = mPink[1];
+      float b2 = mPink[2];
+      for (uint32_t i = 0; i < n; ++i) {
+        const float w = in[i];
+        b0 = 0.99765f * b0 + w * 0.0990460f;
+        b1 = 0.96300f * b1 + w * 0.2965164f;
+        b2 = 0.57000f * b2 + w * 1.0526913f;
+        out[i] = 0.337f * (b0 + b1 + b2 + w * 0.1848f);
+      }
+      mPink[0] = b0;
+      mPink[1] = b1;
+      mPink[2] = b2;
+    }
+    
+    /*===========================================================================*/
+    /* Members Vars                                                              */
+    /*===========================================================================*/
+
+    uint32_t mState[k_lanes]; // xorshift32 lanes
+    float    mPink[3];        // pink filter states
+  };
+}
+
+/** @} */
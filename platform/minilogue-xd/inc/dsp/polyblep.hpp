@@ -0,0 +1,367 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+
+#include "fixed_math.h"
+#include "float_math.h"
+
+/**
+ * @file    polyblep.hpp
+ * @brief   Band-limited oscillator using polynomial step and ramp corrections.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ */
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Band-limited saw, square, pulse and triangle oscillator.
+   *
+   * Naive waveforms computed from an integer phase, with 2-point polynomial corrections (PolyBLEP) around
+   * discontinuities and around slope changes (PolyBLAMP) for the triangle. Needs no tables, and optionally
+   * hard syncs to a master phase.
+   */
+  struct PolyBLEPOsc {
+
+    /*===========================================================================*/
+    /* Types and Data Structures.                                                */
+    /*===========================================================================*/
+
+    /**
+     * Waveforms
+     */
+    enum {
+      k_wave_saw = 0,
+      k_wave_square,
+      k_wave_pulse,
+      k_wave_triangle,
+      k_wave_count
+    };
+    
+    /*===========================================================================*/
+    /* Constructor / Destructor.                                                 */
+    /*===========================================================================*/
+
+    /**
+     * Default constructor
+     */
+    PolyBLEPOsc(void) :
+      phi0(0), w0(0), pw(0x80000000), pending(0.f), skip0(0)
+    { }
+    
+    /*===========================================================================*/
+    /* Public Methods.                                                           */
+    /*===========================================================================*/
+
+    /**
+     * Reset phase
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void reset(void)
+    {
+      phi0 = 0;
+      pending = 0.f;
+      skip0 = 0;
+    }
+
+    /**
+     * Set oscillator frequency
+     *
+     * @param f0 Frequency in Hz
+     * @param fsrecip Reciprocal of sampling frequency (1/Fs)
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setF0(const float f0, const float fsrecip)
+    {
+      w0 = (uint32_t)f32_to_q31(2.f * f0 * fsrecip);
+    }
+
+    /**
+     * Set phase increment, e.g.: as returned by osc_w0u_for_note().
+     *
+     * @param w Phase increment, full cycle over 2^32
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setW0(const uint32_t w)
+    {
+      w0 = w;
+    }
+
+    /**
+     * Set pulse width of k_wave_pulse
+     *
+     * @param width Pulse width in [0.01, 0.99]
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setPulseWidth(const float width)
+    {
+      pw = (uint32_t)f32_to_q31(clipminmaxf(0.01f, width, 0.99f)) << 1;
+    }
+
+    /**
+     * Step residual of a unit discontinuity.
+     *
+     * @param s Time relative to discontinuity in samples, in (-1, 1).
+     */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float blep(const float s)
+    {
+      return (s < 0.f) ? 0.5f * (1.f + s) * (1.f + s) : -0.5f * (1.f - s) * (1.f - s);
+    }
+
+    /**
+     * Ramp residual of a unit change of slope (per sample).
+     *
+     * @param s Time relative to slope change in samples, in (-1, 1).
+     */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float blamp(const float s)
+    {
+      const float x = 1.f - si_fabsf(s);
+      return 0.16666666666667f * x * x * x;
+    }
+
+    /**
+     * Render a block of samples.
+     *
+     * @tparam wave Waveform, one of k_wave_saw, k_wave_square, k_wave_pulse, k_wave_triangle.
+     * @param  out  Output buffer.
+     * @param  n    Number of samples to render.
+     */
+    template<uint8_t wave>
+    inline __attribute__((optimize("Ofast")))
+    void render(float * __restrict out, const uint32_t n)
+    {
+      uint32_t sync_phi = 0;
+      renderImpl<wave, false>(out, n, sync_phi, 0);
+    }
+
+    /**
+     * Render a block of samples, hard synced to a master phase.
+     *
+     * Phase is reset whenever master phase wraps around, and the resulting discontinuity is corrected.
+     *
+     * @tparam wave      Waveform, one of k_wave_saw, k_wave_square, k_wave_pulse, k_wave_triangle.
+     * @param  out       Output buffer.
+     * @param  n         Number of samples to render.
+     * @param  sync_phi  Master phase, full cycle over 2^32, advanced by n samples on return.
+     * @param  sync_w    Master phase increment, full cycle over 2^32.
+     */
+    template<uint8_t wave>
+    inline __attribute__((optimize("Ofast")))
+    void renderSync(float * __restrict out, const uint32_t n, uint32_t &sync_phi, const uint32_t sync_w)
+    {
+      renderImpl<wave, true>(out, n, sync_phi, sync_w);
+    }
+
+    /**
+     * Stateless sample evaluation, e.g.: for use as dsp::Unison kernel.
+     *
+     * @tparam wave Waveform, one of k_wave_saw, k_wave_square, k_wave_pulse, k_wave_triangle.
+     */
+    template<uint8_t wave>
+    struct Kernel {
+      /**
+       * @param width Pulse width as phase, only used for k_wave_pulse.
+       */
+      Kernel(const uint32_t width = 0x80000000) :
+        pw(width)
+      { }
+
+      /**
+       * Get corrected waveform value.
+       *
+       * @param phi Phase, full cycle over 2^32.
+       * @param w   Phase increment, full cycle over 2^32.
+       * @param rw  Reciprocal of phase increment.
+       */
+      inline __attribute__((optimize("Ofast"),always_inline))
+      float operator()(const uint32_t phi, const uint32_t w, const float rw) const
+      {
+        return naive<wave>(phi, pw) + corrections<wave>(phi, rw, (float)w * 2.32830643653870e-010f, pw, false);
+      }
+      
+      uint32_t pw;
+    };
+    
+    /*===========================================================================*/
+    /* Private Methods.                                                          */
+    /*===========================================================================*/
+
+    /**
+     * Naive waveform value for phase in [0, 2^32).
+     *
+     * @param phi   Phase.
+     * @param width Pulse width as phase, only used for k_wave_pulse.
+     */
+    template<uint8_t wave>
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float naive(const uint32_t phi, const uint32_t width)
+    {
+      if (wave == k_wave_saw)
+        return q31_to_f32((q31_t)(phi ^ 0x80000000));
+      else if (wave == k_wave_square)
+        return (phi < 0x80000000) ? 1.f : -1.f;
+      else if (wave == k_wave_pulse)
+        return (phi < width) ? 1.f : -1.f;
+      // Triangle, -1 at phase 0 and 1 at phase 0.5
+      return 1.f - 2.f * si_fabsf(q31_to_f32((q31_t)(phi ^ 0x80000000)));
+    }
+
+    /**
+     * Naive waveform slope per cycle for phase in [0, 2^32), only used for triangle.
+     */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float slope(const uint32_t phi)
+    {
+      return (phi < 0x80000000) ? 4.f : -4.f;
+    }
+
+    /**
+     * Corrections for the discontinuities of the waveform occurring around given phase.
+     *
+     * @param phi   Phase.
+     * @param rw    Reciprocal of phase increment.
+     * @param dt    Phase increment in cycles per sample.
+     * @param width Pulse width as phase, only used for k_wave_pulse.
+     * @param skip0 Skip corrections for phase 0, when it is replaced by a sync reset.
+     */
+    template<uint8_t wave>
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float corrections(const uint32_t phi, const float rw, const float dt, const uint32_t width, const bool skip0)
+    {
+      float y = 0.f;
+      // Signed distance to discontinuity in samples, wraps around by design
+      const float s0 = (float)(int32_t)phi * rw;
+      if (!skip0 && s0 > -1.f && s0 < 1.f) {
+        if (wave == k_wave_saw)
+          y -= 2.f * blep(s0);
+        else if (wave == k_wave_triangle)
+          y += 8.f * dt * blamp(s0);
+        else
+          y += 2.f * blep(s0);
+      }
+      if (wave != k_wave_saw) {
+        const uint32_t q = (wave == k_wave_pulse) ? width : 0x80000000;
+        const float s1 = (float)(int32_t)(phi - q) * rw;
+        if (s1 > -1.f && s1 < 1.f) {
+          if (wave == k_wave_triangle)
+            y -= 8.f * dt * blamp(s1);
+          else
+            y -= 2.f * blep(s1);
+        }
+      }
+      return y;
+    }
+
+    template<uint8_t wave, bool sync>
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void renderImpl(float * __restrict out, const uint32_t n, uint32_t &sync_phi, const uint32_t sync_w)
+    {
+      const uint32_t w = w0;
+      if (w == 0) {
+        const float y = naive<wave>(phi0, pw);
+        for (uint32_t i = 0; i < n; ++i)
+          out[i] = y;
+        return;
+      }
+      
+      const float rw = 1.f / (float)w;
+      const float dt = (float)w * 2.32830643653870e-010f; // 1/(1<<32)
+      const float sync_rw = sync ? 1.f / (float)sync_w : 0.f;
+      
+      uint32_t phi = phi0;
+      uint32_t mphi = sync_phi;
+      // Correction carried over from a sync reset just before the previous sample
+      float carry = pending;
+      bool skip = skip0;
+      
+      const float *out_e = out + n;
+      for (; out != out_e; ) {
+        float y = naive<wave>(phi, pw) + carry;
+        carry = 0.f;
+        
+        uint32_t phi_next = phi + w;
+        bool reset = false;
+        if (sync) {
+          const uint32_t mnext = mphi + sync_w;
+          if (sync_w && mnext < mphi) {
+            // Master wraps before next sample, x samples before it
+            const float x = (float)mnext * sync_rw;
+            const uint32_t phi_r = phi + (uint32_t)((1.f - x) * (float)w);
+            const float jump = naive<wave>(0, pw) - naive<wave>(phi_r, pw);
+            y += jump * blep(x - 1.f);
+            carry = jump * blep(x);
+            if (wave == k_wave_triangle) {
+              const float dslope = (slope(0) - slope(phi_r)) * dt;
+              y += dslope * blamp(x - 1.f);
+              carry += dslope * blamp(x);
+            }
+            phi_next = (uint32_t)(x * (float)w);
+            reset = true;
+          }
+          mphi = mnext;
+        }
+
+        y += corrections<wave>(phi, rw, dt, pw, skip || reset);
+        skip = reset;
+        
+        *(out++) = y;
+        phi = phi_next;
+      }
+      
+      phi0 = phi;
+      sync_phi = mphi;
+      pending = carry;
+      skip0 = skip;
+    }
+    
+    /*===========================================================================*/
+    /* Members Vars                                                              */
+    /*===========================================================================*/
+
+    uint32_t phi0;
+    uint32_t w0;
+    uint32_t pw;
+    float    pending;
+    uint8_t  skip0;
+    
+  };
+}
+
+/** @} */
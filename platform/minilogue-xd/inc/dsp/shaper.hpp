@@ -0,0 +1,398 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+
+#include "float_math.h"
+
+/**
+ * @file    shaper.hpp
+ * @brief   Oversampled wavefolder and phase distortion.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ */
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Half-band filter made of two parallel chains of first order allpass sections (polyphase IIR), for 2x up or down
+   * sampling at a cost of N multiplies per low rate sample. Coefficients after Laurent de Soras' HIIR design method.
+   *
+   * Supported sizes:
+   *   2 coefficients: transition band 0.3, 73dB stop band
+   *   3 coefficients: transition band 0.2, 77dB stop band
+   *   4 coefficients: transition band 0.1, 70dB stop band
+   *   8 coefficients: transition band 0.04, 99dB stop band
+   * with transition band relative to the high sampling rate, i.e.: 0.1 at 96kHz passes up to 19.2kHz.
+   *
+   * @tparam N Number of coefficients.
+   */
+  template<uint8_t N>
+  struct HalfBand {
+
+    /*===========================================================================*/
+    /* Constructor / Destructor.                                                 */
+    /*===========================================================================*/
+
+    /**
+     * Default constructor
+     */
+    HalfBand(void)
+    {
+      flush();
+    }
+    
+    /*===========================================================================*/
+    /* Public Methods.                                                           */
+    /*===========================================================================*/
+
+    /**
+     * Flush internal delays
+     */
+    inline __attribute__((optimize("Ofast")))
+    void flush(void)
+    {
+      for (uint32_t k = 0; k < N; ++k)
+        mX[k] = mY[k] = 0.f;
+      mOdd = 0.f;
+    }
+
+    /**
+     * Upsample a block, doubling its length.
+     *
+     * @param in  Input buffer, n samples.
+     * @param out Output buffer, 2n samples.
+     * @param n   Number of input samples.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void up(const float * __restrict in, float * __restrict out, const uint32_t n)
+    {
+      path<0, k_mode_up>(in, out, n);
+      path<1, k_mode_up>(in, out + 1, n);
+    }
+
+    /**
+     * Downsample a block, halving its length.
+     *
+     * @param in  Input buffer, 2n samples.
+     * @param out Output buffer, n samples.
+     * @param n   Number of output samples.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void down(const float * __restrict in, float * __restrict out, const uint32_t n)
+    {
+      path<0, k_mode_down_even>(in, out, n);
+      path<1, k_mode_down_odd>(in, out, n);
+      mOdd = in[2 * n - 1];
+    }
+
+    /*===========================================================================*/
+    /* Private Methods.                                                          */
+    /*===========================================================================*/
+
+    enum {
+      k_mode_up = 0,     // contiguous input, every other output
+      k_mode_down_even,  // even inputs, output stored
+      k_mode_down_odd    // odd inputs delayed by one, output averaged with stored one
+    };
+
+    /**
+     * Run one allpass chain over a block, states kept in locals for the duration of the block.
+     *
+     * @tparam p    Path, 0 for even coefficients, 1 for odd ones.
+     * @tparam mode Input and output addressing.
+     */
+    template<uint8_t p, uint8_t mode>
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void path(const float * __restrict in, float * __restrict out, const uint32_t n)
+    {
+      const float *c = coefs();
+      float x1[N];
+      float y1[N];
+      for (uint32_t k = p; k < N; k += 2) {
+        x1[k] = mX[k];
+        y1[k] = mY[k];
+      }
+      
+      for (uint32_t i = 0; i < n; ++i) {
+        float x;
+        if (mode == k_mode_up)
+          x = in[i];
+        else if (mode == k_mode_down_even)
+          x = in[2 * i];
+        else
+          x = i ? in[2 * i - 1] : mOdd;
+        
+        for (uint32_t k = p; k < N; k += 2) {
+          const float y = c[k] * (x - y1[k]) + x1[k];
+          x1[k] = x;
+          y1[k] = y;
+          x = y;
+        }
+        
+        if (mode == k_mode_up)
+          out[2 * i] = x;
+        else if (mode == k_mode_down_even)
+          out[i] = x;
+        else
+          out[i] = 0.5f * (out[i] + x);
+      }
+      
+      for (uint32_t k = p; k < N; k += 2) {
+        mX[k] = x1[k];
+        mY[k] = y1[k];
+      }
+    }
+
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    const float *coefs(void)
+    {
+      static const float c2[2] = { 0.1247445257f, 0.5625849529f };
+      static const float c3[3] = { 0.0814300232f, 0.3156598402f, 0.7097708001f };
+      static const float c4[4] = { 0.0798664262f, 0.2838293449f, 0.5453236511f, 0.8344118915f };
+      static const float c8[8] = { 0.0406334609f, 0.1505051290f, 0.3007570560f, 0.4607745050f,
+                                   0.6095243149f, 0.7385038411f, 0.8492238104f, 0.9497427837f };
+      switch (N) { // Resolved at compile time
+        case 2:  return c2;
+        case 3:  return c3;
+        case 4:  return c4;
+        default: return c8;
+      }
+    }
+    
+    /*===========================================================================*/
+    /* Members Vars                                                              */
+    /*===========================================================================*/
+
+    float mX[N];  // allpass section inputs
+    float mY[N];  // allpass section outputs
+    float mOdd;   // last odd input sample when downsampling
+  };
+
+  /**
+   * Shaper quality tiers, trading CPU for aliasing.
+   */
+  enum ShaperQuality {
+    k_shaper_2x = 0, // 2x, 4 coefficient half-band
+    k_shaper_4x,     // 4x, 4 then 2 coefficient half-bands
+    k_shaper_4x_hq   // 4x, 8 then 3 coefficient half-bands
+  };
+
+  /**
+   * Oversampled waveshaping stage.
+   *
+   * Runs a shaping function at 2x or 4x the sampling rate, through polyphase half-band up and down sampling, one block
+   * at a time. Provides a sine wavefolder, a phase distortion oscillator (Casio CZ style cosine with a warped phase),
+   * and oversampling of any other function, e.g.: osc_sat_cubicf().
+   *
+   * Quality is chosen at compile time, see ShaperQuality. Filter states are shared, so an instance should only be used
+   * for one signal.
+   *
+   * @tparam Q Quality tier.
+   */
+  template<uint8_t Q>
+  struct Shaper {
+
+    /*===========================================================================*/
+    /* Types and Data Structures.                                                */
+    /*===========================================================================*/
+
+    enum {
+      k_factor = (Q == k_shaper_2x) ? 2 : 4,
+      k_coefs0 = (Q == k_shaper_4x_hq) ? 8 : 4,
+      k_coefs1 = (Q == k_shaper_4x_hq) ? 3 : 2,
+      k_chunk = 16 // base rate samples per internal pass, bounds stack use
+    };
+
+    /**
+     * Sine wavefolder, sin(pi/2 * drive * x).
+     */
+    struct Fold {
+      Fold(const float d) : drive(d) { }
+
+      inline __attribute__((optimize("Ofast"),always_inline))
+      float operator()(const float x) const
+      {
+        return Shaper::sine(0.25f * drive * x);
+      }
+
+      float drive;
+    };
+
+    /*===========================================================================*/
+    /* Constructor / Destructor.                                                 */
+    /*===========================================================================*/
+
+    /**
+     * Default constructor
+     */
+    Shaper(void)
+    { }
+    
+    /*===========================================================================*/
+    /* Public Methods.                                                           */
+    /*===========================================================================*/
+
+    /**
+     * Flush filter states.
+     */
+    inline __attribute__((optimize("Ofast")))
+    void flush(void)
+    {
+      mUp0.flush();
+      mUp1.flush();
+      mDown0.flush();
+      mDown1.flush();
+    }
+
+    /**
+     * Shape a block of samples in place.
+     *
+     * Shaping functions are provided by F, any type providing:
+     *
+     *   float operator()(const float x) const
+     *
+     * @param buf   Input and output buffer.
+     * @param n     Number of samples.
+     * @param shape Shaping function.
+     */
+    template<typename F>
+    inline __attribute__((optimize("Ofast")))
+    void process(float * __restrict buf, const uint32_t n, const F &shape)
+    {
+      float t2[2 * k_chunk];
+      float t4[4 * k_chunk];
+      float *hi = (k_factor == 2) ? t2 : t4;
+      
+      for (uint32_t i = 0; i < n; i += k_chunk) {
+        const uint32_t m = (n - i < k_chunk) ? n - i : k_chunk;
+        mUp0.up(buf + i, t2, m);
+        if (k_factor == 4)
+          mUp1.up(t2, t4, 2 * m);
+        for (uint32_t j = 0; j < k_factor * m; ++j)
+          hi[j] = shape(hi[j]);
+        if (k_factor == 4)
+          mDown1.down(t4, t2, 2 * m);
+        mDown0.down(t2, buf + i, m);
+      }
+    }
+
+    /**
+     * Fold a block of samples in place.
+     *
+     * @param buf   Input and output buffer.
+     * @param n     Number of samples.
+     * @param drive Input gain, 1 for a quarter sine, each further 2 adds a fold.
+     */
+    inline __attribute__((optimize("Ofast")))
+    void fold(float * __restrict buf, const uint32_t n, const float drive)
+    {
+      process(buf, n, Fold(drive));
+    }
+
+    /**
+     * Render a block of phase distortion cosine, overwriting output.
+     *
+     * The phase is warped piecewise linearly so that the first half cycle is covered within a fraction of the period,
+     * from a plain cosine at amount 0 to a saw like shape approaching 1.
+     *
+     * @param out    Output buffer.
+     * @param n      Number of samples.
+     * @param phi    Phase, full cycle over 2^32, advanced by n samples on return.
+     * @param w      Phase increment, full cycle over 2^32.
+     * @param amount Distortion amount in [0, 1].
+     */
+    inline __attribute__((optimize("Ofast")))
+    void pd(float * __restrict out, const uint32_t n, uint32_t &phi, const uint32_t w, const float amount)
+    {
+      // Inflection point in cycles, and warped slopes either side
+      const float m = 0.5f - 0.49f * clip01f(amount);
+      const float s0 = 0.5f / m;
+      const float s1 = 0.5f / (1.f - m);
+      const uint32_t wq = w / k_factor;
+      uint32_t p = phi;
+      
+      float t2[2 * k_chunk];
+      float t4[4 * k_chunk];
+      float *hi = (k_factor == 2) ? t2 : t4;
+      
+      for (uint32_t i = 0; i < n; i += k_chunk) {
+        const uint32_t cnt = (n - i < k_chunk) ? n - i : k_chunk;
+        for (uint32_t j = 0; j < k_factor * cnt; ++j) {
+          const float x = p * 2.32830643653870e-010f;
+          const float xw = (x < m) ? x * s0 : 0.5f + (x - m) * s1;
+          hi[j] = sine(xw + 0.25f);
+          p += wq;
+        }
+        if (k_factor == 4)
+          mDown1.down(t4, t2, 2 * cnt);
+        mDown0.down(t2, out + i, cnt);
+      }
+      
+      phi = p;
+    }
+
+    /*===========================================================================*/
+    /* Private Methods.                                                          */
+    /*===========================================================================*/
+
+    /**
+     * sin(2 pi x), folding x into a triangle then evaluating a 9th order polynomial.
+     */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float sine(const float x)
+    {
+      float t = x + 0.25f;
+      t -= (float)(int32_t)t;
+      t += (t < 0.f) ? 1.f : 0.f;
+      t = 1.f - 4.f * si_fabsf(t - 0.5f);
+      const float t2 = t * t;
+      return t * (1.5707963f - t2 * (0.6459641f - t2 * (0.0796926f - t2 * (0.0046817f - t2 * 0.0001604f))));
+    }
+    
+    /*===========================================================================*/
+    /* Members Vars                                                              */
+    /*===========================================================================*/
+
+    HalfBand<k_coefs0> mUp0;    // base rate to 2x
+    HalfBand<k_coefs1> mUp1;    // 2x to 4x
+    HalfBand<k_coefs1> mDown1;  // 4x to 2x
+    HalfBand<k_coefs0> mDown0;  // 2x to base rate
+  };
+}
+
+/** @} */
@@ -0,0 +1,260 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+/**
+ * @file    tempoclock.hpp
+ * @brief   Tempo locked phase clock.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ */
+
+#include "int_math.h"
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Tempo locked phase clock.
+   *
+   * Keeps track of musical time in beats with a 64bit fixed point accumulator and derives
+   * the phase of a given note division from it. Since the division phase is derived from
+   * the beat position at every block, it stays locked to the beat across tempo and division
+   * changes, and does not accumulate rounding errors.
+   *
+   * Typical use, once per block: update(fx_get_bpm()), read phase()/w0() or periodSamples(), then advance(frames).
+   */
+  struct TempoClock {
+    
+    /*===========================================================================*/
+    /* Types and Data Structures.                                                */
+    /*===========================================================================*/
+
+    /**
+     * Note divisions
+     */
+    enum {
+      k_div_1_1 = 0,
+      k_div_1_2,
+      k_div_1_4,
+      k_div_1_8,
+      k_div_1_16,
+      k_div_1_32,
+      k_div_1_1_dotted,
+      k_div_1_2_dotted,
+      k_div_1_4_dotted,
+      k_div_1_8_dotted,
+      k_div_1_16_dotted,
+      k_div_1_32_dotted,
+      k_div_1_1_triplet,
+      k_div_1_2_triplet,
+      k_div_1_4_triplet,
+      k_div_1_8_triplet,
+      k_div_1_16_triplet,
+      k_div_1_32_triplet,
+      k_div_count
+    };
+
+    enum {
+      /** Fractional bits of beat accumulator */
+      k_beat_frac_bits = 40,
+      /** Beat accumulator wraps around after this many beats, a multiple of all division periods */
+      k_beat_wrap = 24
+    };
+    
+    /*===========================================================================*/
+    /* Constructor / Destructor.                                                 */
+    /*===========================================================================*/
+
+    /**
+     * Default constructor
+     */
+    TempoClock(void) :
+      mBeats(0),
+      mBeatInc(0),
+      mSampleRate(48000),
+      mBpm(0),
+      mDivNum(1),
+      mDivDen(1),
+      mW0(0),
+      mPeriod(0.f)
+    {
+      setDivision(k_div_1_4);
+    }
+    
+    /*===========================================================================*/
+    /* Public Methods.                                                           */
+    /*===========================================================================*/
+
+    /**
+     * Reset beat position to the start of a bar.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void reset(void)
+    {
+      mBeats = 0;
+    }
+
+    /**
+     * Set sampling rate
+     *
+     * @param fs Sampling rate in Hz
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setSampleRate(const uint32_t fs)
+    {
+      mSampleRate = fs;
+      updateIncrements();
+    }
+    
+    /**
+     * Set note division.
+     *
+     * @param div Note division, one of k_div_1_1 to k_div_1_32_triplet.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setDivision(const uint8_t div)
+    {
+      // Cycles per beat as num/den
+      static const uint8_t divs[k_div_count][2] = {
+        {1, 4}, {2, 4}, {4, 4}, {8, 4}, {16, 4}, {32, 4}, // straight
+        {1, 6}, {2, 6}, {4, 6}, {8, 6}, {16, 6}, {32, 6}, // dotted: 2/3 of straight
+        {3, 8}, {6, 8}, {12, 8}, {24, 8}, {48, 8}, {96, 8} // triplet: 3/2 of straight
+      };
+      const uint8_t idx = (div < k_div_count) ? div : k_div_1_4;
+      mDivNum = divs[idx][0];
+      mDivDen = divs[idx][1];
+      updateIncrements();
+    }
+
+    /**
+     * Update tempo. Meant to be called once per block, increments are only recomputed when tempo changes.
+     *
+     * @param bpm Tempo in BPM multiplied by 10, as returned by fx_get_bpm().
+     * @return True if tempo changed.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    bool update(const uint16_t bpm)
+    {
+      if (bpm == mBpm)
+        return false;
+      mBpm = bpm;
+      updateIncrements();
+      return true;
+    }
+
+    /**
+     * Advance beat position.
+     *
+     * @param frames Number of samples elapsed.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void advance(const uint32_t frames)
+    {
+      static const uint64_t wrap = (uint64_t)k_beat_wrap << k_beat_frac_bits;
+      mBeats += mBeatInc * frames;
+      if (mBeats >= wrap)
+        mBeats -= wrap;
+    }
+
+    /**
+     * Current phase of selected note division.
+     *
+     * @return Phase, full cycle over [0, 2^32).
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    uint32_t phase(void) const
+    {
+      return (uint32_t)(((mBeats * mDivNum) / mDivDen) >> (k_beat_frac_bits - 32));
+    }
+
+    /**
+     * Phase increment per sample of selected note division.
+     *
+     * @return Phase increment, full cycle over 2^32.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    uint32_t w0(void) const
+    {
+      return mW0;
+    }
+    
+    /**
+     * Period of selected note division in samples, e.g.: for tempo synced delay times.
+     *
+     * @return Period in samples, 0 if tempo is unknown.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float periodSamples(void) const
+    {
+      return mPeriod;
+    }
+
+    /**
+     * Recompute increments for current tempo, division and sampling rate.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void updateIncrements(void)
+    {
+      if (mBpm == 0) {
+        mBeatInc = 0;
+        mW0 = 0;
+        mPeriod = 0.f;
+        return;
+      }
+      // beats per sample = bpm / (600 * fs), with bpm multiplied by 10
+      const uint64_t denom = 600ULL * mSampleRate;
+      mBeatInc = (((uint64_t)mBpm << k_beat_frac_bits) + (denom >> 1)) / denom;
+      mW0 = (uint32_t)(((mBeatInc * mDivNum) / mDivDen) >> (k_beat_frac_bits - 32));
+      mPeriod = (float)(denom * mDivDen) / (float)((uint32_t)mBpm * mDivNum);
+    }
+      
+    /*===========================================================================*/
+    /* Member Variables.                                                         */
+    /*===========================================================================*/
+
+    uint64_t mBeats;
+    uint64_t mBeatInc;
+    uint32_t mSampleRate;
+    uint16_t mBpm;
+    uint8_t  mDivNum;
+    uint8_t  mDivDen;
+    uint32_t mW0;
+    float    mPeriod;
+  };
+}
+
+/** @} */
@@ -0,0 +1,317 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+
+#include "float_math.h"
+#include "delayline.hpp"
+#include "biquad.hpp"
+
+/**
+ * @file    waveguide.hpp
+ * @brief   Plucked string waveguide.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ */
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Karplus-Strong style plucked string.
+   *
+   * The loop is made of a delay line of integer length, a first order allpass tuning the fractional part of the period,
+   * and a one pole low pass loss filter scaled by a loop gain. The allpass and loop gain are solved for the fundamental
+   * once per pitch or parameter change, accounting for the loss filter phase delay and attenuation, so that tuning and
+   * decay time do not depend on damping.
+   *
+   * Memory is provided by the caller and only needs to hold the period of the lowest note to be played, see
+   * lineSize(). Lower notes play at the lowest supported pitch.
+   */
+  struct Waveguide {
+
+    /*===========================================================================*/
+    /* Types and Data Structures.                                                */
+    /*===========================================================================*/
+
+    /**
+     * Delay line size in samples for given lowest fundamental, rounded up to a power of two.
+     *
+     * @param lowest_hz Lowest fundamental to be played.
+     * @param fs        Sampling frequency.
+     */
+    static constexpr uint32_t lineSize(const float lowest_hz, const float fs)
+    {
+      return pow2AtLeast((uint32_t)(fs / lowest_hz) + 3);
+    }
+
+    /*===========================================================================*/
+    /* Constructor / Destructor.                                                 */
+    /*===========================================================================*/
+
+    /**
+     * Default constructor
+     */
+    Waveguide(void) :
+      mW0(0.f), mDecay(1.f), mDamping(0.f), mFs(48000.f),
+      mApCoeff(0.f), mApX(0.f), mApY(0.f), mGain(0.f), mLength(1), mMaxLength(0)
+    {
+      mLoss.mCoeffs.setPoleLP(0.f);
+    }
+    
+    /*===========================================================================*/
+    /* Public Methods.                                                           */
+    /*===========================================================================*/
+
+    /**
+     * Set the memory area to use as delay line.
+     *
+     * @param ram       Pointer to memory buffer.
+     * @param line_size Size in float of memory buffer, a power of two, e.g.: from lineSize().
+     */
+    inline __attribute__((optimize("Ofast")))
+    void setMemory(float *ram, const size_t line_size)
+    {
+      mLine.setMemory(ram, line_size);
+      mLine.clear();
+      mMaxLength = line_size - 2;
+      update();
+    }
+
+    /**
+     * Set sampling frequency.
+     */
+    inline __attribute__((optimize("Ofast")))
+    void setSampleRate(const float fs)
+    {
+      mFs = fs;
+      update();
+    }
+
+    /**
+     * Set fundamental. Recomputes tuning on change only.
+     *
+     * @param w0 Phase increment in (0, 0.5), e.g.: from osc_w0f_for_pitch().
+     */
+    inline __attribute__((optimize("Ofast")))
+    void setPitch(const float w0)
+    {
+      if (w0 == mW0)
+        return;
+      mW0 = w0;
+      update();
+    }
+
+    /**
+     * Set decay time of the fundamental.
+     *
+     * @param t60 Time to decay by 60dB, in seconds.
+     */
+    inline __attribute__((optimize("Ofast")))
+    void setDecay(const float t60)
+    {
+      mDecay = t60;
+      update();
+    }
+
+    /**
+     * Set damping, i.e.: how much faster high partials decay.
+     *
+     * @param pole Loss filter pole in [0, 1), 0 for no damping.
+     */
+    inline __attribute__((optimize("Ofast")))
+    void setDamping(const float pole)
+    {
+      mDamping = pole;
+      mLoss.mCoeffs.setPoleLP(pole);
+      update();
+    }
+
+    /**
+     * Excite the string with a burst of noise, replacing the period currently in the loop.
+     *
+     * @param noise Noise source returning samples in [-1, 1], e.g.: osc_white.
+     * @param amp   Excitation amplitude.
+     * @param color One pole smoothing of the burst in (0, 1], 1 for white noise, lower for softer plucks.
+     */
+    template<typename F>
+    inline __attribute__((optimize("Ofast")))
+    void pluck(F noise, const float amp, const float color)
+    {
+      float z = 0.f;
+      for (uint32_t i = 0; i <= mLength; ++i) {
+        z += color * (noise() - z);
+        mLine.write(amp * z);
+      }
+      mApX = mApY = 0.f;
+      mLoss.flush();
+    }
+
+    /**
+     * Render a block of samples, overwriting output.
+     *
+     * @param out Output buffer.
+     * @param n   Number of samples to render.
+     */
+    inline __attribute__((optimize("Ofast")))
+    void render(float * __restrict out, const uint32_t n)
+    {
+      const uint32_t len = mLength;
+      const float a = mApCoeff;
+      const float g = mGain;
+      float x1 = mApX;
+      float y1 = mApY;
+      
+      for (uint32_t i = 0; i < n; ++i) {
+        const float x = mLine.read(len);
+        y1 = a * (x - y1) + x1;
+        x1 = x;
+        const float y = g * mLoss.process_fo(y1);
+        mLine.write(y);
+        out[i] = y;
+      }
+      
+      mApX = x1;
+      mApY = y1;
+    }
+
+    /*===========================================================================*/
+    /* Private Methods.                                                          */
+    /*===========================================================================*/
+
+    static constexpr uint32_t pow2AtLeast(const uint32_t x, const uint32_t p = 1)
+    {
+      return (p >= x) ? p : pow2AtLeast(x, p << 1);
+    }
+
+    /**
+     * Solve delay length, allpass coefficient and loop gain for current parameters.
+     */
+    inline __attribute__((optimize("Ofast")))
+    void update(void)
+    {
+      if (mW0 <= 0.f || mMaxLength < 2)
+        return;
+      
+      float period = 1.f / mW0;
+      if (period > mMaxLength)
+        period = mMaxLength;
+      const float w = 2.f * (float)M_PI / period;
+
+      // Loss filter phase delay and log2 magnitude at the fundamental
+      const float p = mDamping;
+      const float sh = sine(0.5f * w);
+      const float cw = 1.f - 2.f * sh * sh;
+      const float sw = 2.f * sh * cosine(0.5f * w);
+      const float re = 1.f - p * cw;
+      const float lp_delay = arctan(p * sw / re) / w;
+      const float lp_gain = (p > 0.f) ? fastlog2f(1.f - p) - 0.5f * fastlog2f(re * re + p * p * sw * sw) : 0.f;
+
+      // Integer delay leaving a fractional part in [0.618, 1.618) for the allpass
+      float rem = period - lp_delay - 0.618f;
+      if (rem < 1.f)
+        rem = 1.f;
+      mLength = (uint32_t)rem;
+      float frac = period - lp_delay - mLength;
+      if (frac < 0.1f)
+        frac = 0.1f; // keeps the allpass stable at the very top of the range
+      
+      // Exact first order allpass phase delay at the fundamental
+      mApCoeff = sine(0.5f * w * (1.f - frac)) / sine(0.5f * w * (1.f + frac));
+
+      // Loop gain for -60dB after t60 at the fundamental, i.e.: 2^(-log2(1000) / (t60 * f0)) per period
+      float lg = -9.965784f * period / (mDecay * mFs) - lp_gain;
+      if (lg > -1e-6f)
+        lg = -1e-6f;
+      mGain = fastpow2f(lg);
+    }
+
+    /**
+     * sin(x) for x in [-pi, pi].
+     */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float sine(const float x)
+    {
+      const float x2 = x * x;
+      return x * (1.f - x2 * (1.f/6.f - x2 * (1.f/120.f - x2 * (1.f/5040.f - x2 * (1.f/362880.f - x2 * (1.f/39916800.f))))));
+    }
+
+    /**
+     * cos(x) for x in [-pi/2, pi/2].
+     */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float cosine(const float x)
+    {
+      const float x2 = x * x;
+      return 1.f - x2 * (0.5f - x2 * (1.f/24.f - x2 * (1.f/720.f - x2 * (1.f/40320.f - x2 * (1.f/3628800.f)))));
+    }
+
+    /**
+     * atan(x) for x >= 0.
+     *
+     * @note Abramowitz & Stegun 4.4.48, error below 1.8e-6 on [0, 1].
+     */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float arctan(const float x)
+    {
+      const bool inv = x > 1.f;
+      const float t = inv ? 1.f / x : x;
+      const float t2 = t * t;
+      const float a = t * (0.9999772f + t2 * (-0.3326235f + t2 * (0.1935435f + t2 * (-0.1164329f
+                                                                    + t2 * (0.0526533f + t2 * -0.0117212f)))));
+      return inv ? (float)M_PI_2 - a : a;
+    }
+    
+    /*===========================================================================*/
+    /* Members Vars                                                              */
+    /*===========================================================================*/
+
+    DelayLine mLine;
+    BiQuad    mLoss;      // loss filter, first order
+    float     mW0;        // fundamental phase increment
+    float     mDecay;     // t60 in seconds
+    float     mDamping;   // loss filter pole
+    float     mFs;        // sampling frequency
+    float     mApCoeff;   // tuning allpass coefficient
+    float     mApX;       // tuning allpass state
+    float     mApY;
+    float     mGain;      // loop gain
+    uint32_t  mLength;    // integer delay
+    uint32_t  mMaxLength; // longest integer delay the memory allows
+  };
+}
+
+/** @} */
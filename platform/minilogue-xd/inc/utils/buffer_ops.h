@@ -91,6 +91,26 @@ void buf_f32_to_q31(const float *flt,
   }
 }
 
+/** Buffer-wise float to Q31 conversion, saturating.
+ *
+ *  Values outside [-1, 1) are clamped to the Q31 extrema by the conversion itself, so blocks rendered in floating
+ *  point can be converted in one pass without clipping each sample beforehand.
+ */
+static inline __attribute__((optimize("Ofast"),always_inline))
+void buf_f32_to_q31_sat(const float *flt,
+                        q31_t * __restrict__ q31,
+                        const size_t len)
+{
+  const float *end = flt + ((len>>2)<<2);
+  for (; flt != end; ) {
+    REP4(*(q31++) = f32_to_q31_sat(*(flt++)));
+  }
+  end += len & 0x3;
+  for (; flt != end; ) {
+    *(q31++) = f32_to_q31_sat(*(flt++));
+  }
+}
+
 //** @} */
 
 /**
@@ -173,6 +193,251 @@ void buf_cpy_u32(const uint32_t *src,
 
 //** @} */
 
+/**
+ * @name    Buffer arithmetic
+ * @note    Destination buffers may be the same as a source buffer for in-place processing.
+ * @{
+ */
+
+/** Buffer-wise addition, dst = a + b.
+ */
+static inline __attribute__((optimize("Ofast"),always_inline))
+void buf_add_f32(const float *a,
+                 const float *b,
+                 float *dst,
+                 const size_t len)
+{
+  const float *end = dst + ((len>>2)<<2);
+  for (; dst != end; ) {
+    REP4(*(dst++) = *(a++) + *(b++));
+  }
+  end += len & 0x3;
+  for (; dst != end; ) {
+    *(dst++) = *(a++) + *(b++);
+  }
+}
+
+/** Buffer-wise multiplication, dst = a * b.
+ */
+static inline __attribute__((optimize("Ofast"),always_inline))
+void buf_mul_f32(const float *a,
+                 const float *b,
+                 float *dst,
+                 const size_t len)
+{
+  const float *end = dst + ((len>>2)<<2);
+  for (; dst != end; ) {
+    REP4(*(dst++) = *(a++) * *(b++));
+  }
+  end += len & 0x3;
+  for (; dst != end; ) {
+    *(dst++) = *(a++) * *(b++);
+  }
+}
+
+/** Buffer scaling by a constant gain, dst = gain * src.
+ */
+static inline __attribute__((optimize("Ofast"),always_inline))
+void buf_scale_f32(const float *src,
+                   float *dst,
+                   const size_t len,
+                   const float gain)
+{
+  const float *end = dst + ((len>>2)<<2);
+  for (; dst != end; ) {
+    REP4(*(dst++) = gain * *(src++));
+  }
+  end += len & 0x3;
+  for (; dst != end; ) {
+    *(dst++) = gain * *(src++);
+  }
+}
+
+/** Buffer multiply-accumulate by a constant gain, acc += gain * src.
+ *
+ *  E.g.: summing the sub timbre into the main timbre.
+ */
+static inline __attribute__((optimize("Ofast"),always_inline))
+void buf_mac_f32(const float *src,
+                 float *acc,
+                 const size_t len,
+                 const float gain)
+{
+  const float *end = acc + ((len>>2)<<2);
+  for (; acc != end; ) {
+    REP4(*(acc++) += gain * *(src++));
+  }
+  end += len & 0x3;
+  for (; acc != end; ) {
+    *(acc++) += gain * *(src++);
+  }
+}
+
+//** @} */
+
+/**
+ * @name    Buffer ramps and mixing
+ * @note    Ramps start at the first value on the first sample and reach the second value on the sample following the
+ *          buffer, so that consecutive buffers ramped from g0 to g1 then g1 to g2 join without steps.
+ * @{
+ */
+
+/** Buffer scaling by a linearly ramped gain, dst = g * src with g going from g0 to g1.
+ */
+static inline __attribute__((optimize("Ofast"),always_inline))
+void buf_ramp_f32(const float *src,
+                  float *dst,
+                  const size_t len,
+                  float g0,
+                  const float g1)
+{
+  // Four interleaved gains stepping by four increments, independent across lanes
+  const float dg = (g1 - g0) / len;
+  const float dg4 = 4 * dg;
+  float ga = g0, gb = g0 + dg, gc = g0 + 2 * dg, gd = g0 + 3 * dg;
+  const float *end = dst + ((len>>2)<<2);
+  for (; dst != end; dst += 4, src += 4) {
+    dst[0] = ga * src[0];
+    dst[1] = gb * src[1];
+    dst[2] = gc * src[2];
+    dst[3] = gd * src[3];
+    ga += dg4; gb += dg4; gc += dg4; gd += dg4;
+  }
+  end += len & 0x3;
+  for (; dst != end; ga += dg) {
+    *(dst++) = ga * *(src++);
+  }
+}
+
+/** Buffer crossfade with linearly ramped mix, dst = a + mix * (b - a) with mix going from mix0 to mix1.
+ *
+ *  E.g.: dry/wet mixing, with a the dry signal and b the wet signal.
+ */
+static inline __attribute__((optimize("Ofast"),always_inline))
+void buf_xfade_f32(const float *a,
+                   const float *b,
+                   float *dst,
+                   const size_t len,
+                   float mix0,
+                   const float mix1)
+{
+  // Four interleaved mixes stepping by four increments, as for buf_ramp_f32()
+  const float dmix = (mix1 - mix0) / len;
+  const float dmix4 = 4 * dmix;
+  float ma = mix0, mb = mix0 + dmix, mc = mix0 + 2 * dmix, md = mix0 + 3 * dmix;
+  const float *end = dst + ((len>>2)<<2);
+  for (; dst != end; dst += 4, a += 4, b += 4) {
+    dst[0] = linintf(ma, a[0], b[0]);
+    dst[1] = linintf(mb, a[1], b[1]);
+    dst[2] = linintf(mc, a[2], b[2]);
+    dst[3] = linintf(md, a[3], b[3]);
+    ma += dmix4; mb += dmix4; mc += dmix4; md += dmix4;
+  }
+  end += len & 0x3;
+  for (; dst != end; ma += dmix) {
+    *(dst++) = linintf(ma, *(a++), *(b++));
+  }
+}
+
+//** @} */
+
+/**
+ * @name    Buffer interleaving
+ * @note    Lengths are in frames, interleaved buffers hold 2 * len samples, e.g.: the L/R layout of effect buffers.
+ * @{
+ */
+
+/** Interleave two mono buffers into a stereo buffer.
+ */
+static inline __attribute__((optimize("Ofast"),always_inline))
+void buf_interleave_f32(const float *l,
+                        const float *r,
+                        float * __restrict__ lr,
+                        const size_t len)
+{
+  const float *end = l + ((len>>2)<<2);
+  for (; l != end; ) {
+    REP4((*(lr++) = *(l++), *(lr++) = *(r++)));
+  }
+  end += len & 0x3;
+  for (; l != end; ) {
+    *(lr++) = *(l++);
+    *(lr++) = *(r++);
+  }
+}
+
+/** Deinterleave a stereo buffer into two mono buffers.
+ */
+static inline __attribute__((optimize("Ofast"),always_inline))
+void buf_deinterleave_f32(const float *lr,
+                          float * __restrict__ l,
+                          float * __restrict__ r,
+                          const size_t len)
+{
+  const float *end = l + ((len>>2)<<2);
+  for (; l != end; ) {
+    REP4((*(l++) = *(lr++), *(r++) = *(lr++)));
+  }
+  end += len & 0x3;
+  for (; l != end; ) {
+    *(l++) = *(lr++);
+    *(r++) = *(lr++);
+  }
+}
+
+//** @} */
+
+/**
+ * @name    Buffer level measurement
+ * @{
+ */
+
+/** Peak absolute value of a buffer.
+ */
+static inline __attribute__((optimize("Ofast"),always_inline))
+float buf_peak_f32(const float *src,
+                   const size_t len)
+{
+  // Independent partial maxima, as for buf_rms_f32()
+  float p0 = 0.f, p1 = 0.f, p2 = 0.f, p3 = 0.f;
+  const float *end = src + ((len>>2)<<2);
+  for (; src != end; src += 4) {
+    p0 = clipminf(p0, si_fabsf(src[0]));
+    p1 = clipminf(p1, si_fabsf(src[1]));
+    p2 = clipminf(p2, si_fabsf(src[2]));
+    p3 = clipminf(p3, si_fabsf(src[3]));
+  }
+  end += len & 0x3;
+  for (; src != end; ++src) {
+    p0 = clipminf(p0, si_fabsf(src[0]));
+  }
+  return clipminf(clipminf(p0, p1), clipminf(p2, p3));
+}
+
+/** Root mean square of a buffer, 0 for an empty buffer.
+ */
+static inline __attribute__((optimize("Ofast"),always_inline))
+float buf_rms_f32(const float *src,
+                  const size_t len)
+{
+  // Independent partial sums, avoids stalling on the accumulator
+  float s0 = 0.f, s1 = 0.f, s2 = 0.f, s3 = 0.f;
+  const float *end = src + ((len>>2)<<2);
+  for (; src != end; src += 4) {
+    s0 += src[0] * src[0];
+    s1 += src[1] * src[1];
+    s2 += src[2] * src[2];
+    s3 += src[3] * src[3];
+  }
+  end += len & 0x3;
+  for (; src != end; ++src) {
+    s0 += src[0] * src[0];
+  }
+  return (len) ? sqrtf(((s0 + s1) + (s2 + s3)) / len) : 0.f;
+}
+
+//** @} */
+
 #endif // __buffer_ops_h
 
 /** @} @} */
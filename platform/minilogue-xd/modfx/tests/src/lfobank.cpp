@@ -0,0 +1,84 @@
+/*
+ * File: lfobank.cpp
+ *
+ * Simple runtime test using LFOBank class as audio rate oscillators
+ *
+ * 
+ * 
+ * 2018 (c) Korg
+ *
+ */
+
+#include "usermodfx.h"
+
+#include "lfobank.hpp"
+
+static dsp::LFOBank<4> s_lfos;
+
+enum {
+  k_block_size = 64
+};
+
+static float s_spread_z, s_spread;
+static float s_f0;
+static const float s_fs_recip = 1.f / 48000.f;
+
+void MODFX_INIT(uint32_t platform, uint32_t api)
+{
+  s_lfos.reset();
+  s_lfos.setF0(220.f,s_fs_recip);
+  s_spread_z = s_spread = 1.f;
+  s_f0 = 220.f;
+}
+
+void MODFX_PROCESS(const float *main_xn, float *main_yn,
+                   const float *sub_xn,  float *sub_yn,
+                   uint32_t frames)
+{
+  float * __restrict my = main_yn;
+  const float * my_e = my + 2*frames;
+  float * __restrict sy = sub_yn;
+
+  // Phase spread is only applied at block boundaries, frequencies are shared.
+  if (s_spread_z != s_spread) {
+    s_spread_z = s_spread;
+    s_lfos.setPhaseSpread(s_spread_z);
+  }
+  s_lfos.setF0(s_f0, s_fs_recip);
+  
+  // Interleaved as main L, main R, sub L, sub R
+  float wave_buf[4 * k_block_size];
+  
+  for (; my != my_e; ) {
+    const uint32_t remaining = (my_e - my) >> 1;
+    const uint32_t count = (remaining < k_block_size) ? remaining : k_block_size;
+    
+    s_lfos.render<dsp::SimpleLFO::k_wave_triangle, false>(wave_buf, count);
+
+    const float *w = wave_buf;
+    const float *w_e = w + 4 * count;
+    for (; w != w_e; w += 4) {
+      // Scale down the wave, full swing is way too loud. (polyphony headroom)
+      *(my++) = 0.1f * w[0];
+      *(my++) = 0.1f * w[1];
+      *(sy++) = 0.1f * w[2];
+      *(sy++) = 0.1f * w[3];
+    }
+  }
+}
+
+
+void MODFX_PARAM(uint8_t index, int32_t value)
+{
+  const float valf = q31_to_f32(value);
+  switch (index) {
+  case k_user_modfx_param_time:
+    s_f0 = 110.f + valf * 330.f;
+    break;
+  case k_user_modfx_param_depth:
+    s_spread = valf;
+    break;
+  default:
+    break;
+  }
+}
@@ -0,0 +1,150 @@
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+/*
+ * File: additive.cpp
+ *
+ * Additive oscillator bank test
+ *
+ */
+
+#include "userosc.h"
+
+#include "additive.hpp"
+#include "buffer_ops.h"
+
+enum {
+  k_block_size = 64,
+  k_partials = 32
+};
+
+typedef dsp::Additive<k_partials> Bank;
+
+typedef struct State {
+  Bank bank;
+  float tilt;
+  float even;
+  bool update;
+} State;
+
+static State s_state;
+
+static void update_amplitudes(void)
+{
+  // Partial k at 1/(k+1)^tilt, even harmonics scaled, normalized to unit sum
+  float amp[k_partials];
+  float sum = 0.f;
+  for (uint32_t k = 0; k < k_partials; ++k) {
+    amp[k] = fastpowf(k + 1, -s_state.tilt);
+    if (k & 1)
+      amp[k] *= s_state.even;
+    sum += amp[k];
+  }
+  const float norm = 0.5f / sum;
+  for (uint32_t k = 0; k < k_partials; ++k)
+    amp[k] *= norm;
+  s_state.bank.setAmplitudes(amp);
+}
+
+void OSC_INIT(uint32_t platform, uint32_t api)
+{
+  s_state.bank = Bank();
+  s_state.tilt = 1.f;
+  s_state.even = 1.f;
+  s_state.update = true;
+}
+
+void OSC_CYCLE(const user_osc_param_t * const params,
+               int32_t *yn,
+               const uint32_t frames)
+{
+  Bank &bank = s_state.bank;
+  
+  if (s_state.update) {
+    update_amplitudes();
+    s_state.update = false;
+  }
+  bank.setPitch(osc_w0f_for_pitch(params->pitch));
+  
+  float buf[k_block_size];
+  
+  q31_t * __restrict y = (q31_t *)yn;
+  const q31_t * y_e = y + frames;
+  
+  for (; y != y_e; ) {
+    const uint32_t remaining = y_e - y;
+    const uint32_t count = (remaining < k_block_size) ? remaining : k_block_size;
+
+    bank.render(buf, count);
+    // Partials can momentarily add up beyond full scale
+    buf_f32_to_q31_sat(buf, y, count);
+    y += count;
+  }
+}
+
+void OSC_NOTEON(const user_osc_param_t * const params)
+{
+  (void)params;
+}
+
+void OSC_NOTEOFF(const user_osc_param_t * const params)
+{
+  (void)params;
+}
+
+void OSC_PARAM(uint16_t index, uint16_t value)
+{
+  const float valf = param_val_to_f32(value);
+  
+  switch (index) {
+  case k_user_osc_param_id1:
+  case k_user_osc_param_id2:
+  case k_user_osc_param_id3:
+  case k_user_osc_param_id4:
+  case k_user_osc_param_id5:
+  case k_user_osc_param_id6:
+    break;
+  case k_user_osc_param_shape:
+    // Spectral tilt, from 0 (flat) to 2 (1/k^2)
+    s_state.tilt = 2.f * valf;
+    s_state.update = true;
+    break;
+  case k_user_osc_param_shiftshape:
+    // Even harmonics level
+    s_state.even = 1.f - valf;
+    s_state.update = true;
+    break;
+  default:
+    break;
+  }
+}
@@ -71,11 +71,11 @@ void OSC_CYCLE(const user_osc_param_t * const params,
       * -----------------------------------------------------------*/ 
       if (s.duophonic)                                                 //Pitch is 16 bit : High Byte 0xffff (0-255): Low Bye 0xfff (0-255)
       {
-        s_waves.updateW1(osc_w0f_for_note( (uint8_t) (( (params->pitch)>>8 ) + 12 * s_waves.params.coar_2), params->pitch & 0xFF));
+        s_waves.updateW1(osc_w0u_for_note( (uint8_t) (( (params->pitch)>>8 ) + 12 * s_waves.params.coar_2), params->pitch & 0xFF));
         
         if (s.coarChangeCar)                                           //Update Pitch only on Coar_1 Param change
         {
-            s_waves.updateW0(osc_w0f_for_note( (uint8_t) (( s_waves.state.initNoteVal ) + 12 * s_waves.params.coar_1), params->pitch & 0xFF));
+            s_waves.updateW0(osc_w0u_for_note( (uint8_t) (( s_waves.state.initNoteVal ) + 12 * s_waves.params.coar_1), params->pitch & 0xFF));
             s_waves.state.coarChangeCar = false;
         }
         
@@ -86,8 +86,8 @@ void OSC_CYCLE(const user_osc_param_t * const params,
       * -----------------------------------------------------------*/ 
       else 
       {
-         s_waves.updatePitch(osc_w0f_for_note( (uint8_t) (( (params->pitch)>>8 ) + 6 * p.coar_1), params->pitch & 0xFF),
-                             osc_w0f_for_note( (uint8_t) (( (params->pitch)>>8 ) + 6 * p.coar_2), params->pitch & 0xFF));
+         s_waves.updatePitch(osc_w0u_for_note( (uint8_t) (( (params->pitch)>>8 ) + 6 * p.coar_1), params->pitch & 0xFF),
+                             osc_w0u_for_note( (uint8_t) (( (params->pitch)>>8 ) + 6 * p.coar_2), params->pitch & 0xFF));
       }
     
 
@@ -99,7 +99,7 @@ void OSC_CYCLE(const user_osc_param_t * const params,
       if (s.refreshEnv)
       {
           s.updateDexedEnv();
-          s.fb_shift = s.feedback != 0 ? 8 - s.feedback : 16;
+          s.ops.setFeedbackShift(s.feedback != 0 ? 8 - s.feedback : 16);
     
           s.refreshEnv = false;
       }
@@ -110,30 +110,24 @@ void OSC_CYCLE(const user_osc_param_t * const params,
   
   
   /* -------------------------------------------------------------------
-   * DEXED ENV and Feedback CALC
+   * DEXED ENV and LFO CALC
+   * 
+   * LFO mix is folded into the Q24 gain ramp, so the sample loop only 
+   * ramps a single integer gain
    * -------------------------------------------------------------------*/
-  int32_t gain1     = s.oldLevel_;
-  int32_t envOutInt = s.getDexedSample( (int32_t) frames ); 
+  int32_t gain1, dgain;
+  s.env.gainRamp(frames, gain1, dgain);      // Q24 linear gain, 2^(level - 14)
+  int32_t gain2 = s.env.getGain();
   
+  const float lfoMix1 = clipminmaxf(0.005f, 1.0f - s.lfoz, 0.995f);   // Z indicates old value of LFO
+  const float lfoMix2 = clipminmaxf(0.005f, 1.0f - s.lfo,  0.995f);
+  s.lfoz              = s.lfo;
   
-  float envOutFlo = envOutInt * 0.00000006f; // 2^-24 = 0.00000006
-  int32_t gain2   = int32_t ( exp2( envOutFlo - 14.0f ) * pow(2, 24) ) ; // Convert back to Q24
-  s.oldLevel_     = gain2;                   //Set for next OSC Cycle
+  gain1 = int32_t(gain1 * lfoMix1);
+  gain2 = int32_t(gain2 * lfoMix2);
 
-  int32_t dgain = (gain2 - gain1 + (int32_t) (frames >> 1)) / (int32_t) frames; // Didn't cast frames to int32_t before which caused the output to be pure noise, 
-                                                                                // Remember to watch those datatypes kids!
-  int32_t gain  = gain1;
-
-  int32_t y0 = s.fb_buffer[0];
-  int32_t y1 = s.fb_buffer[1];
-  
-  
-  float phi0 = s.phi0;
-  float phi1 = s.phi1;
-  float det  = s.detune;
-  
-  float lfoz = s.lfoz;                            // Z indicates old value of LFO
-  const float lfo_inc = (s.lfo - lfoz) / frames;  // Calc phase increment for LFO
+  dgain = (gain2 - gain1 + (int32_t) (frames >> 1)) / (int32_t) frames; // Didn't cast frames to int32_t before which caused the output to be pure noise, 
+                                                                        // Remember to watch those datatypes kids!
   
   
   
@@ -144,80 +138,30 @@ void OSC_CYCLE(const user_osc_param_t * const params,
     * -------------------------------------------------------------------*/
   float freqhz      = osc_notehzf((params->pitch)>>8);    
 //   float detuneRatio = 0.0209f * fastexpf(-0.396f * ((freq / (1<<24)))) / 1024.0f;
-  double detuneRatio = (0.000051728 * freqhz) / 15;            // The float was chosen because at +15 the max detune added is ~= 10 hz
-  det               = detuneRatio * freqhz * (p.detune - 15); 
-  det               *= k_samplerate_recipf;
+  float detuneRatio = (0.000051728f * freqhz) / 15;            // The float was chosen because at +15 the max detune added is ~= 10 hz
+  float det         = detuneRatio * freqhz * (p.detune - 15); 
+  det              *= k_samplerate_recipf;
+  s.detune          = det;
+  
+  const uint32_t w0 = s.w0 + (uint32_t)(int32_t)(det * 4294967296.f); // Phase increments, full cycle over 2^32
+  const uint32_t w1 = s.w1;
     
   
   
 // ****************************************************************************
 // SAMPLE CYCLE
+// 
+// The OP pair renders the whole block with waveforms and route fixed, 
+// the combination is picked once here instead of for every sample.
+// 
+// TODO : Maybe morph between waveforms instead of switching?
+// TODO : I want a way to quantize the input into the sin function
 // ****************************************************************************
   
-  q31_t * __restrict y = (q31_t *)yn;
-  const q31_t * y_e    = y + frames;
+  const SineWaves::OpPair::RenderFunc render = SineWaves::OpPair::renderFunc(s.carWavShap, s.modWavShap, s.isRouteSerial);
+  
+  (s.ops.*render)((q31_t *)yn, frames, w0, w1, gain1, dgain);
   
-  for (; y != y_e; )
-  {
-    
-   /* -------------------------------------------------------------------
-    * WAVESHAPE
-    * 
-    * TODO : Maybe morph between waveforms instead of switching?
-    *
-    * -------------------------------------------------------------------*/ 
-
-    float (*waveTypeCar)(float x); 
-    float (*waveTypeMod)(float x);
-    
-    switch (s.carWavShap)
-    {
-        case 0: waveTypeCar = osc_sinf; break;
-        case 1: waveTypeCar = osc_sawf; break;
-        case 2: waveTypeCar = osc_sqrf; break;
-        case 3: waveTypeCar = osc_parf; break;
-        default:waveTypeCar = osc_sinf; break;
-    }    
-    
-    switch (s.modWavShap)
-    {
-        case 0: waveTypeMod = osc_sinf; break;
-        case 1: waveTypeMod = osc_sawf; break;
-        case 2: waveTypeMod = osc_sqrf; break;
-        case 3: waveTypeMod = osc_parf; break;
-        default:waveTypeMod = osc_sinf; break;
-    }    
-    
-    
-    
-   /* -------------------------------------------------------------------
-    * SIGNAL ROUTE
-    * 
-    * TODO : I want a way to quantize the input into the sin function
-    * TODO : Implement the Shape LFO param to control the Volume of the Mod OP
-    *        
-    * -------------------------------------------------------------------*/ 
-    float sig;
-   
-    gain             += dgain;
-    double gainf      = (0.00000006f * gain);
-    int32_t scaled_fb = (y0 + y1) >> (s.fb_shift + 1);
-    
-    y0 = y1;
-    
-    double scaled_fbf = scaled_fb * 0.00000006f;
-    float lfoMix      = clipminmaxf(0.005f, 1.0f - lfoz, 0.995f);
-    float modOpOut    = waveTypeMod(phi1 + scaled_fbf) * (gainf * lfoMix);
-    
-    y1 = int32_t( modOpOut * pow(2, 24) );
-    
-    if (s.isRouteSerial) 
-        sig = 0.250f * waveTypeCar(phi0 + modOpOut);  //LFO shape can be added here. possibly (modOpOut * lfoz) + phi0
-        
-    else 
-        sig = 0.250f * waveTypeCar(phi0) + 0.250f * (waveTypeMod(phi1) * modOpOut);
-    
-    
    /* -------------------------------------------------------------------
     * DISTORTION (No longer part of OSC anymore)
     * 
@@ -235,22 +179,6 @@ void OSC_CYCLE(const user_osc_param_t * const params,
     //     sig            = (1.f - p.distort) * sig + (p.distort * dist_sig); /* Mix b/t the rounded signal and the orig */
     //     sig            = clip1m1f(sig);
     //     
-    
-    *(y++) = f32_to_q31(sig);
-    
-    phi0 += s.w0 + det;
-    phi0 -= (uint32_t)phi0;
-    phi1 += s.w1;
-    phi1 -= (uint32_t)phi1;
-    lfoz += lfo_inc;
-  }
-  
-  s.fb_buffer[0] = y0;
-  s.fb_buffer[1] = y1;
-  
-  s.phi0 = phi0;
-  s.phi1 = phi1;
-  s.lfo  = lfoz;
   
 }
 
@@ -268,7 +196,7 @@ void OSC_NOTEON(const user_osc_param_t * const params)
     if (s_waves.state.holdCarPitch && s_waves.state.duophonic) //Check if hold Carrier Pitch is set to true by the note release function
     { 
         s_waves.state.initNoteVal = (params->pitch)>>8;  
-        s_waves.updateW0(osc_w0f_for_note( (uint8_t) ((s_waves.state.initNoteVal) + 12 * s_waves.params.coar_1), params->pitch & 0xFF));
+        s_waves.updateW0(osc_w0u_for_note( (uint8_t) ((s_waves.state.initNoteVal) + 12 * s_waves.params.coar_1), params->pitch & 0xFF));
         s_waves.state.holdCarPitch = false;  
     }
     
@@ -281,7 +209,7 @@ void OSC_NOTEOFF(const user_osc_param_t * const params)
    
    (void)params;
    
-   s_waves.state.keydown(false);
+   s_waves.state.env.keydown(false);
    
    if(s_waves.state.duophonic)
       s_waves.state.holdCarPitch = true;
@@ -0,0 +1,263 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+
+#include "float_math.h"
+
+/**
+ * @file    hardsync.hpp
+ * @brief   Hard sync and phase reset with minBLEP correction.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ */
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Hard synced oscillator for arbitrary phase indexed waveforms, e.g.: osc_wave_scanuf() wave tables.
+   *
+   * The slave phase is reset whenever the master phase wraps around. The reset position is computed to sub-sample
+   * accuracy from the master phase, and the resulting step is corrected by adding a minimum phase band-limited step
+   * residual (minBLEP) to the following samples. Being minimum phase, corrections only affect samples after the step,
+   * so they are accumulated in a small ring buffer and no latency is added. Explicit phase resets, e.g.: on note on,
+   * are corrected the same way.
+   *
+   * Only steps are corrected, slope changes at the reset point are left as is. For the analytic waveforms of
+   * dsp::PolyBLEPOsc, its own renderSync() also corrects those.
+   */
+  struct HardSync {
+
+    /*===========================================================================*/
+    /* Types and Data Structures.                                                */
+    /*===========================================================================*/
+
+    enum {
+      k_blep_taps = 8,    // residual length in samples, power of two
+      k_blep_phases = 16, // residual table points per sample
+      k_blep_size = k_blep_taps * k_blep_phases + 1
+    };
+
+    /*===========================================================================*/
+    /* Constructor / Destructor.                                                 */
+    /*===========================================================================*/
+
+    /**
+     * Default constructor
+     */
+    HardSync(void) :
+      mPhi(0), mW(0), mMasterPhi(0), mMasterW(0), mResetPhi(0), mResetPending(0), mIdx(0)
+    {
+      clear();
+    }
+    
+    /*===========================================================================*/
+    /* Public Methods.                                                           */
+    /*===========================================================================*/
+
+    /**
+     * Reset phases and drop pending corrections, without correction.
+     */
+    inline __attribute__((optimize("Ofast")))
+    void clear(void)
+    {
+      mPhi = mMasterPhi = 0;
+      mResetPending = 0;
+      for (uint32_t k = 0; k < k_blep_taps; ++k)
+        mRing[k] = 0.f;
+    }
+
+    /**
+     * Set slave phase increment, e.g.: as returned by osc_w0u_for_note().
+     *
+     * @param w Phase increment, full cycle over 2^32.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setW0(const uint32_t w)
+    {
+      mW = w;
+    }
+
+    /**
+     * Set master phase increment.
+     *
+     * @param w Phase increment, full cycle over 2^32, 0 to disable sync.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setMasterW0(const uint32_t w)
+    {
+      mMasterW = w;
+    }
+
+    /**
+     * Reset slave and master phases at the start of the next block, with correction of the resulting step.
+     *
+     * @param phi Slave phase to reset to.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void resetPhase(const uint32_t phi = 0)
+    {
+      mResetPhi = phi;
+      mResetPending = 1;
+    }
+
+    /**
+     * Render a block of samples, overwriting output.
+     *
+     * Waveforms are provided by W, any type providing:
+     *
+     *   float operator()(const uint32_t phi) const
+     *
+     * for a phase, full cycle over 2^32, e.g.: wrapping osc_wave_scanuf() and a wave table.
+     *
+     * @param out  Output buffer.
+     * @param n    Number of samples to render.
+     * @param wave Waveform.
+     */
+    template<typename W>
+    inline __attribute__((optimize("Ofast")))
+    void render(float * __restrict out, const uint32_t n, const W &wave)
+    {
+      uint32_t phi = mPhi;
+      uint32_t mphi = mMasterPhi;
+      const uint32_t w = mW;
+      const uint32_t mw = mMasterW;
+      const float mrw = mw ? 1.f / (float)mw : 0.f;
+      
+      if (mResetPending) {
+        addResidual(wave(mResetPhi) - wave(phi), 0.f);
+        phi = mResetPhi;
+        mphi = 0;
+        mResetPending = 0;
+      }
+      
+      for (uint32_t i = 0; i < n; ++i) {
+        out[i] = wave(phi) + mRing[mIdx];
+        mRing[mIdx] = 0.f;
+        mIdx = (mIdx + 1) & (k_blep_taps - 1);
+
+        const uint32_t mnext = mphi + mw;
+        if (mnext < mphi) {
+          // Master wraps x samples before next sample
+          const float x = (float)mnext * mrw;
+          const uint32_t phi_r = phi + (uint32_t)((1.f - x) * (float)w);
+          const uint32_t phi_next = (uint32_t)(x * (float)w);
+          addResidual(wave(0) - wave(phi_r), x);
+          phi = phi_next;
+        }
+        else
+          phi += w;
+        mphi = mnext;
+      }
+      
+      mPhi = phi;
+      mMasterPhi = mphi;
+    }
+
+    /**
+     * Band-limited step residual, i.e.: minBLEP minus unit step.
+     *
+     * @param t Time since step in samples, in [0, k_blep_taps).
+     */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float residual(const float t)
+    {
+      // Blackman windowed sinc with 8 zero crossings per side, minimum phase, integrated, minus unit step, then
+      // faded out by a half Hann window over the table so that truncation leaves no step
+      static const float table[k_blep_size] = {
+        -9.99999821e-01f, -9.99848247e-01f, -9.99393225e-01f, -9.98632133e-01f, -9.97560501e-01f, -9.96171117e-01f,
+        -9.94453013e-01f, -9.92390513e-01f, -9.89961803e-01f, -9.87137675e-01f, -9.83880222e-01f, -9.80141461e-01f,
+        -9.75862086e-01f, -9.70970571e-01f, -9.65382099e-01f, -9.58998621e-01f, -9.51708376e-01f, -9.43386853e-01f,
+        -9.33897614e-01f, -9.23094392e-01f, -9.10823405e-01f, -8.96926820e-01f, -8.81246209e-01f, -8.63627434e-01f,
+        -8.43925536e-01f, -8.22010338e-01f, -7.97771990e-01f, -7.71127284e-01f, -7.42024839e-01f, -7.10451066e-01f,
+        -6.76434994e-01f, -6.40052140e-01f, -6.01428032e-01f, -5.60740054e-01f, -5.18217862e-01f, -4.74142671e-01f,
+        -4.28844810e-01f, -3.82699311e-01f, -3.36120307e-01f, -2.89553732e-01f, -2.43468568e-01f, -1.98347002e-01f,
+        -1.54673636e-01f, -1.12924002e-01f, -7.35529587e-02f, -3.69830169e-02f, -3.59328859e-03f, 2.62907855e-02f,
+        5.24064377e-02f, 7.45610073e-02f, 9.26375538e-02f, 1.06598333e-01f, 1.16486073e-01f, 1.22422934e-01f,
+        1.24607123e-01f, 1.23307258e-01f, 1.18854731e-01f, 1.11634158e-01f, 1.02072380e-01f, 9.06263068e-02f,
+        7.77700022e-02f, 6.39814958e-02f, 4.97297719e-02f, 3.54622640e-02f, 2.15934720e-02f, 8.49484466e-03f,
+        -3.51356738e-03f, -1.41695673e-02f, -2.32731346e-02f, -3.06885708e-02f, -3.63444239e-02f, -4.02313285e-02f,
+        -4.23978604e-02f, -4.29446734e-02f, -4.20172140e-02f, -3.97973172e-02f, -3.64940464e-02f, -3.23342122e-02f,
+        -2.75528673e-02f, -2.23841909e-02f, -1.70530789e-02f, -1.17676994e-02f, -6.71326509e-03f, -2.04718392e-03f,
+        2.10432475e-03f, 5.64810308e-03f, 8.52445792e-03f, 1.07061816e-02f, 1.21963462e-02f, 1.30250435e-02f,
+        1.32453153e-02f, 1.29284998e-02f, 1.21592460e-02f, 1.10304551e-02f, 9.63836443e-03f, 8.07799399e-03f,
+        6.43911725e-03f, 4.80290223e-03f, 3.23931011e-03f, 1.80529768e-03f, 5.43834176e-04f, -5.16305212e-04f,
+        -1.36003771e-03f, -1.98486145e-03f, -2.39925459e-03f, -2.62071867e-03f, -2.67360522e-03f, -2.58686231e-03f,
+        -2.39183079e-03f, -2.12020031e-03f, -1.80221943e-03f, -1.46522932e-03f, -1.13256369e-03f, -8.22834962e-04f,
+        -5.49601275e-04f, -3.21387633e-04f, -1.42015808e-04f, -1.11848349e-05f, 7.47658851e-05f, 1.21982477e-04f,
+        1.38182688e-04f, 1.31768349e-04f, 1.11021545e-04f, 8.34306047e-05f, 5.51781450e-05f, 3.08094568e-05f,
+        1.30849003e-05f, 3.00684883e-06f, 0.00000000e+00f,
+      };
+      const float p = t * k_blep_phases;
+      const uint32_t i = (uint32_t)p;
+      const float frac = p - i;
+      return linintf(frac, table[i], table[i + 1]);
+    }
+
+    /*===========================================================================*/
+    /* Private Methods.                                                          */
+    /*===========================================================================*/
+
+    /**
+     * Accumulate correction for a step occurring x samples before the sample at the current ring index.
+     *
+     * @param jump Step height.
+     * @param x    Offset of the step before next sample, in [0, 1).
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void addResidual(const float jump, const float x)
+    {
+      for (uint32_t k = 0; k < k_blep_taps; ++k)
+        mRing[(mIdx + k) & (k_blep_taps - 1)] += jump * residual(k + x);
+    }
+    
+    /*===========================================================================*/
+    /* Members Vars                                                              */
+    /*===========================================================================*/
+
+    uint32_t mPhi;          // slave phase
+    uint32_t mW;            // slave phase increment
+    uint32_t mMasterPhi;    // master phase
+    uint32_t mMasterW;      // master phase increment
+    uint32_t mResetPhi;     // slave phase for pending reset
+    uint8_t  mResetPending;
+    uint8_t  mIdx;          // ring index of next sample
+    float    mRing[k_blep_taps]; // corrections for the next samples
+  };
+}
+
+/** @} */
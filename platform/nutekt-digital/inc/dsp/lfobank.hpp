@@ -0,0 +1,238 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+
+#include "fixed_math.h"
+#include "float_math.h"
+
+#include "simplelfo.hpp"
+
+/**
+ * @file    lfobank.hpp
+ * @brief   Bank of LFOs with related phases.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ */
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Bank of N LFOs, e.g.: for ensemble and chorus modulation.
+   *
+   * Phases and increments are stored as arrays so that all N outputs of a sample are
+   * computed in a single fixed length loop, which the compiler can unroll or vectorize.
+   * Phase conventions match SimpleLFO, waveform shapes are computed in float to
+   * avoid saturating integer ops in the inner loop.
+   *
+   * @tparam N Number of LFOs.
+   */
+  template<uint32_t N>
+  struct LFOBank {
+
+    /*===========================================================================*/
+    /* Types and Data Structures.                                                */
+    /*===========================================================================*/
+
+    enum {
+      k_voices = N
+    };
+    
+    /*===========================================================================*/
+    /* Constructor / Destructor.                                                 */
+    /*===========================================================================*/
+
+    /**
+     * Default constructor, phases evenly spread over a cycle.
+     */
+    LFOBank(void)
+    {
+      for (uint32_t i = 0; i < N; ++i)
+        w0[i] = 0;
+      reset();
+    }
+    
+    /*===========================================================================*/
+    /* Public Methods.                                                           */
+    /*===========================================================================*/
+
+    /**
+     * Step all phases one cycle forward
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void cycle(void)
+    {
+      for (uint32_t i = 0; i < N; ++i)
+        phi0[i] += w0[i];
+    }
+
+    /**
+     * Reset phases, evenly spread over a cycle.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void reset(void)
+    {
+      phi0[0] = 0x80000000;
+      setPhaseSpread(1.f);
+    }
+
+    /**
+     * Set phases relative to first LFO, which keeps running undisturbed.
+     *
+     * LFO i is offset by i * spread / N cycles, a spread of 1 distributes phases evenly over a cycle.
+     *
+     * @param spread Phase spread in [0, 1]
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setPhaseSpread(const float spread)
+    {
+      // spread / N of a 2^32 cycle, a single LFO needs no step and a full cycle would not fit in 32 bits
+      const uint32_t step = (N > 1) ? (uint32_t)(clip01f(spread) * (4294967296.f / N)) : 0;
+      uint32_t phi = phi0[0] + step;
+      for (uint32_t i = 1; i < N; ++i, phi += step)
+        phi0[i] = phi;
+    }
+
+    /**
+     * Set the same frequency for all LFOs
+     *
+     * @param f0 Frequency in Hz
+     * @param fsrecip Reciprocal of sampling frequency (1/Fs)
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setF0(const float f0, const float fsrecip)
+    {
+      const uint32_t w = (uint32_t)f32_to_q31(2.f * f0 * fsrecip);
+      for (uint32_t i = 0; i < N; ++i)
+        w0[i] = w;
+    }
+
+    /**
+     * Set frequency of a single LFO
+     *
+     * @param idx LFO index in [0, N-1]
+     * @param f0 Frequency in Hz
+     * @param fsrecip Reciprocal of sampling frequency (1/Fs)
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setF0(const uint32_t idx, const float f0, const float fsrecip)
+    {
+      w0[idx] = (uint32_t)f32_to_q31(2.f * f0 * fsrecip);
+    }
+
+    /**
+     * Get value of given waveform for arbitrary phase, float equivalent of SimpleLFO::shape().
+     *
+     * @tparam wave Waveform, one of SimpleLFO::k_wave_sine, k_wave_triangle, k_wave_saw, k_wave_square.
+     * @tparam uni  True for positive unipolar output, false for bipolar output.
+     * @param  phi  Phase in Q31.
+     */
+    template<uint8_t wave, bool uni>
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float shape(const q31_t phi)
+    {
+      const float phif = q31_to_f32(phi);
+      if (wave == SimpleLFO::k_wave_sine)
+        return uni ? 0.5f + 2 * phif * (si_fabsf(phif) - 1.f) : 4 * phif * (si_fabsf(phif) - 1.f);
+      else if (wave == SimpleLFO::k_wave_triangle)
+        return uni ? si_fabsf(phif) : 2 * si_fabsf(phif) - 1.f;
+      else if (wave == SimpleLFO::k_wave_saw)
+        return uni ? 0.5f * phif + 0.5f : phif;
+      return (phif < 0.f) ? (uni ? 0.f : -1.f) : 1.f;
+    }
+
+    /**
+     * Step phases one cycle forward and get values of all LFOs.
+     *
+     * @tparam wave Waveform, one of SimpleLFO::k_wave_sine, k_wave_triangle, k_wave_saw, k_wave_square.
+     * @tparam uni  True for positive unipolar output, false for bipolar output.
+     * @param  out  Output, N values.
+     */
+    template<uint8_t wave, bool uni>
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void process(float * __restrict out)
+    {
+      for (uint32_t i = 0; i < N; ++i) {
+        phi0[i] += w0[i];
+        out[i] = shape<wave, uni>((q31_t)phi0[i]);
+      }
+    }
+
+    /**
+     * Render a block of LFO values, interleaved as N values per sample.
+     *
+     * @tparam wave Waveform, one of SimpleLFO::k_wave_sine, k_wave_triangle, k_wave_saw, k_wave_square.
+     * @tparam uni  True for positive unipolar output, false for bipolar output.
+     * @param  out  Output buffer, N * n values.
+     * @param  n    Number of samples to render.
+     */
+    template<uint8_t wave, bool uni>
+    inline __attribute__((optimize("Ofast")))
+    void render(float * __restrict out, const uint32_t n)
+    {
+      // Local copy of state so the inner loop works on registers
+      uint32_t phi[N];
+      uint32_t w[N];
+      for (uint32_t i = 0; i < N; ++i) {
+        phi[i] = phi0[i];
+        w[i] = w0[i];
+      }
+      
+      const float *out_e = out + N * n;
+      for (; out != out_e; out += N) {
+        for (uint32_t i = 0; i < N; ++i) {
+          phi[i] += w[i];
+          out[i] = shape<wave, uni>((q31_t)phi[i]);
+        }
+      }
+      
+      for (uint32_t i = 0; i < N; ++i)
+        phi0[i] = phi[i];
+    }
+    
+    /*===========================================================================*/
+    /* Members Vars                                                              */
+    /*===========================================================================*/
+
+    // Unsigned to keep wrap around well defined, same layout as SimpleLFO phases otherwise
+    uint32_t phi0[N];
+    uint32_t w0[N];
+    
+  };
+}
+
+/** @} */
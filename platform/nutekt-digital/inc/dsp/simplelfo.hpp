@@ -57,6 +57,24 @@ namespace dsp {
     /*===========================================================================*/
     /* Types and Data Structures.                                                */
     /*===========================================================================*/
+
+    /**
+     * Waveforms available to block rendering.
+     */
+    enum {
+      k_wave_sine = 0,
+      k_wave_triangle,
+      k_wave_saw,
+      k_wave_square,
+      k_wave_count
+    };
+
+    /**
+     * Block render method, as returned by renderFunc().
+     *
+     * Arguments are output buffer, number of samples and phase offset in [-1, 1].
+     */
+    typedef void (SimpleLFO::*RenderFunc)(float * __restrict, const uint32_t, const float);
       
     /*===========================================================================*/
     /* Constructor / Destructor.                                                 */
@@ -114,6 +132,19 @@ namespace dsp {
       w0 = f32_to_q31(2.f * w);
     }
     
+    /**
+     * Set phase and phase increment from unsigned 32bit phase values, e.g.: as provided by dsp::TempoClock
+     *
+     * @param phi Phase, full cycle over [0, 2^32)
+     * @param w Phase increment per sample, full cycle over 2^32
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setPhaseU32(const uint32_t phi, const uint32_t w) 
+    {
+      phi0 = (q31_t)(phi + 0x80000000);
+      w0 = (q31_t)w;
+    }
+    
     // --- Sinusoids --------------
 
     /**
@@ -291,6 +322,158 @@ namespace dsp {
       return (phi < 0) ? 0.f : 1.f;
     }
       
+    // --- Block rendering --------------
+
+    /**
+     * Get value of given waveform for arbitrary phase.
+     *
+     * @tparam wave Waveform, one of k_wave_sine, k_wave_triangle, k_wave_saw, k_wave_square.
+     * @tparam uni  True for positive unipolar output, false for bipolar output.
+     * @param  phi  Phase in Q31.
+     */
+    template<uint8_t wave, bool uni>
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    float shape(const q31_t phi)
+    {
+      if (wave == k_wave_sine) {
+        const float phif = q31_to_f32(phi);
+        return uni ? 0.5f + 2 * phif * (si_fabsf(phif) - 1.f) : 4 * phif * (si_fabsf(phif) - 1.f);
+      }
+      else if (wave == k_wave_triangle) {
+        return uni ? si_fabsf(q31_to_f32(phi)) : q31_to_f32(qsub(q31abs(phi),0x40000000)<<1);
+      }
+      else if (wave == k_wave_saw) {
+        return uni ? q31_to_f32(qadd((phi>>1),0x40000000)) : q31_to_f32(phi);
+      }
+      return (phi < 0) ? (uni ? 0.f : -1.f) : 1.f;
+    }
+
+    /**
+     * Render a block of LFO values, stepping phase one cycle forward before each sample.
+     *
+     * @tparam wave   Waveform, one of k_wave_sine, k_wave_triangle, k_wave_saw, k_wave_square.
+     * @tparam uni    True for positive unipolar output, false for bipolar output.
+     * @tparam off    True to apply phase offset.
+     * @param  out    Output buffer.
+     * @param  n      Number of samples to render.
+     * @param  offset Offset to apply to phase, in [-1, 1]. Ignored if off is false.
+     */
+    template<uint8_t wave, bool uni, bool off>
+    inline __attribute__((optimize("Ofast")))
+    void render(float * __restrict out, const uint32_t n, const float offset)
+    {
+      // Unsigned phase arithmetic, wraps around by design
+      const uint32_t phoff = off ? ((uint32_t)f32_to_q31(offset)<<1) : 0;
+      const uint32_t w = w0;
+      uint32_t phi = phi0;
+      
+      const float *out_e = out + n;
+      for (; out != out_e; ) {
+        phi += w;
+        *(out++) = shape<wave, uni>((q31_t)(phi + phoff));
+      }
+
+      phi0 = phi;
+    }
+
+    /**
+     * Render a block of LFO values, evaluating the waveform every K samples and interpolating linearly in between.
+     *
+     * Suited for LFO rates far below audio rate. Saw and square discontinuities become linear transitions over K samples.
+     *
+     * @tparam wave   Waveform, one of k_wave_sine, k_wave_triangle, k_wave_saw, k_wave_square.
+     * @tparam uni    True for positive unipolar output, false for bipolar output.
+     * @tparam off    True to apply phase offset.
+     * @tparam K      Decimation factor, preferably a power of two.
+     * @param  out    Output buffer.
+     * @param  n      Number of samples to render.
+     * @param  offset Offset to apply to phase, in [-1, 1]. Ignored if off is false.
+     *
+     * @note Trailing samples when n is not a multiple of K are evaluated directly.
+     */
+    template<uint8_t wave, bool uni, bool off, uint32_t K>
+    inline __attribute__((optimize("Ofast")))
+    void renderDecimated(float * __restrict out, const uint32_t n, const float offset)
+    {
+      // Unsigned phase arithmetic, wraps around by design
+      const uint32_t phoff = off ? ((uint32_t)f32_to_q31(offset)<<1) : 0;
+      const uint32_t w = w0;
+      const uint32_t wk = w * K;
+      uint32_t phi = phi0;
+      
+      float y0 = shape<wave, uni>((q31_t)(phi + w + phoff));
+      
+      const float *out_e = out + (n - (n % K));
+      for (; out != out_e; ) {
+        phi += wk;
+        const float y1 = shape<wave, uni>((q31_t)(phi + w + phoff));
+        const float dy = (y1 - y0) * (1.f / K);
+        for (uint32_t i = 0; i < K; ++i) {
+          *(out++) = y0;
+          y0 += dy;
+        }
+        y0 = y1;
+      }
+
+      out_e += n % K;
+      for (; out != out_e; ) {
+        phi += w;
+        *(out++) = shape<wave, uni>((q31_t)(phi + phoff));
+      }
+      
+      phi0 = phi;
+    }
+
+    /**
+     * Select block render method for given waveform and options. Meant to be called once per block.
+     *
+     * @param wave Waveform, one of k_wave_sine, k_wave_triangle, k_wave_saw, k_wave_square.
+     * @param uni  True for positive unipolar output, false for bipolar output.
+     * @param off  True to apply phase offset.
+     * @return     Pointer to member render method, to be invoked as (lfo.*func)(out, n, offset).
+     */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    RenderFunc renderFunc(const uint8_t wave, const bool uni, const bool off)
+    {
+      static const RenderFunc table[k_wave_count][2][2] = {
+        { { &SimpleLFO::render<k_wave_sine, false, false>,     &SimpleLFO::render<k_wave_sine, false, true> },
+          { &SimpleLFO::render<k_wave_sine, true, false>,      &SimpleLFO::render<k_wave_sine, true, true> } },
+        { { &SimpleLFO::render<k_wave_triangle, false, false>, &SimpleLFO::render<k_wave_triangle, false, true> },
+          { &SimpleLFO::render<k_wave_triangle, true, false>,  &SimpleLFO::render<k_wave_triangle, true, true> } },
+        { { &SimpleLFO::render<k_wave_saw, false, false>,      &SimpleLFO::render<k_wave_saw, false, true> },
+          { &SimpleLFO::render<k_wave_saw, true, false>,       &SimpleLFO::render<k_wave_saw, true, true> } },
+        { { &SimpleLFO::render<k_wave_square, false, false>,   &SimpleLFO::render<k_wave_square, false, true> },
+          { &SimpleLFO::render<k_wave_square, true, false>,    &SimpleLFO::render<k_wave_square, true, true> } }
+      };
+      return table[(wave < k_wave_count) ? wave : k_wave_sine][uni][off];
+    }
+
+    /**
+     * Select decimated block render method for given waveform and options. Meant to be called once per block.
+     *
+     * @tparam K    Decimation factor, preferably a power of two.
+     * @param  wave Waveform, one of k_wave_sine, k_wave_triangle, k_wave_saw, k_wave_square.
+     * @param  uni  True for positive unipolar output, false for bipolar output.
+     * @param  off  True to apply phase offset.
+     * @return      Pointer to member render method, to be invoked as (lfo.*func)(out, n, offset).
+     */
+    template<uint32_t K>
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    RenderFunc renderDecimatedFunc(const uint8_t wave, const bool uni, const bool off)
+    {
+      static const RenderFunc table[k_wave_count][2][2] = {
+        { { &SimpleLFO::renderDecimated<k_wave_sine, false, false, K>,     &SimpleLFO::renderDecimated<k_wave_sine, false, true, K> },
+          { &SimpleLFO::renderDecimated<k_wave_sine, true, false, K>,      &SimpleLFO::renderDecimated<k_wave_sine, true, true, K> } },
+        { { &SimpleLFO::renderDecimated<k_wave_triangle, false, false, K>, &SimpleLFO::renderDecimated<k_wave_triangle, false, true, K> },
+          { &SimpleLFO::renderDecimated<k_wave_triangle, true, false, K>,  &SimpleLFO::renderDecimated<k_wave_triangle, true, true, K> } },
+        { { &SimpleLFO::renderDecimated<k_wave_saw, false, false, K>,      &SimpleLFO::renderDecimated<k_wave_saw, false, true, K> },
+          { &SimpleLFO::renderDecimated<k_wave_saw, true, false, K>,       &SimpleLFO::renderDecimated<k_wave_saw, true, true, K> } },
+        { { &SimpleLFO::renderDecimated<k_wave_square, false, false, K>,   &SimpleLFO::renderDecimated<k_wave_square, false, true, K> },
+          { &SimpleLFO::renderDecimated<k_wave_square, true, false, K>,    &SimpleLFO::renderDecimated<k_wave_square, true, true, K> } }
+      };
+      return table[(wave < k_wave_count) ? wave : k_wave_sine][uni][off];
+    }
+      
     /*===========================================================================*/
     /* Members Vars                                                              */
     /*===========================================================================*/
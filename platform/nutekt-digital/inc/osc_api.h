@@ -129,6 +129,139 @@ extern "C" {
 
     return f * k_samplerate_recipf;
   }
+
+  /**
+   * Get integer phase increment for given note and fine modulation
+   *
+   * @param note Note in [0-151] range, mod in [0-255] range.
+   * @return     Corresponding phase increment, full cycle over 2^32.
+   */
+  __fast_inline uint32_t osc_w0u_for_note(uint8_t note, uint8_t mod) {
+    return (uint32_t)(osc_w0f_for_note(note, mod) * 4294967296.f); // 2^32
+  }
+
+#define k_pitch_base_w0f       (1.703291440759e-04f) // 8.1757989Hz (note 0) / 48kHz
+#define k_pitch_fine_size      (16)
+
+  /**
+   * Get floating point phase increment for given pitch, exponential version
+   *
+   * Unlike osc_w0f_for_note(), fine modulation is applied exponentially, so that fine tuning and pitch bend are
+   * exact in cents. Uses an octave shift, a 2^(n/12) semitone table and a 2^(x/12) fine table.
+   *
+   * @param pitch Pitch as in user_osc_param_t, note in upper 8 bits, mod in [0-255] in lower 8 bits.
+   * @return      Corresponding 0-1 phase increment in floating point.
+   */
+  __fast_inline float osc_w0f_for_pitch(uint16_t pitch) {
+    static const float semitones[12] = {
+      1.000000000f, 1.059463094f, 1.122462048f, 1.189207115f, 1.259921050f, 1.334839854f, 1.414213562f, 1.498307077f, 1.587401052f, 1.681792831f, 1.781797436f, 1.887748625f
+    };
+    static const float fine[k_pitch_fine_size+1] = {
+      1.000000000f, 1.003616666f, 1.007246412f, 1.010889286f, 1.014545335f, 1.018214607f,
+      1.021897149f, 1.025593009f, 1.029302237f, 1.033024879f, 1.036760985f, 1.040510603f,
+      1.044273782f, 1.048050572f, 1.051841021f, 1.055645178f, 1.059463094f
+    };
+    const uint32_t note = clipmaxu32(pitch >> 8, k_midi_to_hz_size-1);
+    const uint32_t octave = note / 12;
+    const float finef = (pitch & 0xFF) * k_note_mod_fscale * k_pitch_fine_size;
+    const uint32_t fi = (uint32_t)finef;
+    const float w = k_pitch_base_w0f * (float)(1U << octave) * semitones[note - 12 * octave]
+      * linintf(finef - fi, fine[fi], fine[clipmaxu32(fi + 1, k_pitch_fine_size)]);
+    return clipmaxf(w, k_note_max_hz * k_samplerate_recipf);
+  }
+
+  /**
+   * Get integer phase increment for given pitch, exponential version
+   *
+   * @param pitch Pitch as in user_osc_param_t, note in upper 8 bits, mod in [0-255] in lower 8 bits.
+   * @return      Corresponding phase increment, full cycle over 2^32.
+   */
+  __fast_inline uint32_t osc_w0u_for_pitch(uint16_t pitch) {
+    return (uint32_t)(osc_w0f_for_pitch(pitch) * 4294967296.f); // 2^32
+  }
+
+  /**
+   * Cached pitch to phase increment conversion, see osc_pitch_update().
+   */
+  typedef struct osc_pitch {
+    uint32_t pitch;    ///< Last converted pitch, k_pitch_none before first conversion
+    float    w0f;      ///< 0-1 phase increment in floating point
+    uint32_t w0u;      ///< Phase increment, full cycle over 2^32
+  } osc_pitch_t;
+
+#define k_pitch_none           (0xFFFFFFFFU)
+  
+  /**
+   * Reset pitch cache, next update will convert pitch regardless of its value
+   *
+   * @param c Pitch cache.
+   */
+  __fast_inline void osc_pitch_reset(osc_pitch_t *c) {
+    c->pitch = k_pitch_none;
+    c->w0f = 0.f;
+    c->w0u = 0;
+  }
+
+  /**
+   * Update cached phase increments, only converting pitch if it changed since last update
+   *
+   * @param c     Pitch cache, initialized with osc_pitch_reset().
+   * @param pitch Pitch as in user_osc_param_t.
+   * @return      Non-zero if phase increments changed.
+   */
+  __fast_inline uint8_t osc_pitch_update(osc_pitch_t *c, uint16_t pitch) {
+    if (pitch == c->pitch)
+      return 0;
+    c->pitch = pitch;
+    c->w0f = osc_w0f_for_pitch(pitch);
+    c->w0u = (uint32_t)(c->w0f * 4294967296.f);
+    return 1;
+  }
+  
+  /** @} */
+
+  /**
+   * @name   Cubic interpolated lookups
+   *
+   * Variants of the table lookups below using 4-point Hermite interpolation (see hermintf()) instead of linear
+   * interpolation, for cleaner output at low notes. Only integer phase versions are provided.
+   *
+   * Cost is two extra table reads, about six extra floating point operations and, for half-wave tables, the
+   * wrap fixups of the outer points, roughly 2 to 4 times the cost of the linear versions.
+   * SNR figures are measured against the ideal signal for a 1 kHz tone, with tables band-limited to 23 harmonics.
+   *
+   * @{
+   */
+
+  /**
+   * Cubic interpolated lookup in a 128 point half-wave table, mirrored for second half of period.
+   *
+   * @param   wt   Half-wave table, with guard point.
+   * @param   x    Phase, full cycle over 2^32.
+   * @param   sgn  -1.f for tables negated in second half (sine, saw, square), 1.f otherwise (parabolic).
+   * @return       Wave sample.
+   */
+  __fast_inline float osc_half_hermuf(const float *wt, uint32_t x, float sgn) {
+    const uint32_t x0p = x >> 24;
+    const float fr = 5.96046447753906e-008f * (float)(x & ((1U<<24)-1)); // 1/(1<<24)
+
+    // Position and scan direction in the stored half, reversed for second half
+    int32_t i = x0p, d = 1;
+    float s = 1.f;
+    if (x0p >= 128) {
+      i = 256 - x0p;
+      d = -1;
+      s = sgn;
+    }
+
+    // Outer points may fall one step outside of the stored half
+    const int32_t im1 = i - d;
+    const int32_t i2 = i + 2*d;
+    const float ym1 = (im1 < 0) ? sgn * wt[1] : (im1 > 128) ? sgn * wt[127] : wt[im1];
+    const float y2 = (i2 < 0) ? sgn * wt[1] : (i2 > 128) ? sgn * wt[127] : wt[i2];
+    
+    return s * hermintf(fr, ym1, wt[i], wt[i+d], y2);
+  }
   
   /** @} */
   
@@ -176,6 +309,52 @@ extern "C" {
   __fast_inline float osc_cosf(float x) {
     return osc_sinf(x+0.25f);
   }
+
+  /**
+   * Lookup value of sin(2*pi*x). (integer phase version)
+   *
+   * @param   x  Phase, full cycle over 2^32.
+   * @return     Result of sin(2*pi*x).
+   */
+  __fast_inline float osc_sinuf(uint32_t x) {
+    const uint32_t x0p = x >> k_wt_sine_u32shift;
+    const uint32_t x0 = x0p & k_wt_sine_mask;
+    const float fr = k_wt_sine_frrecip * (float)(x & ((1U<<k_wt_sine_u32shift)-1));
+    const float y0 = linintf(fr, wt_sine_lut_f[x0], wt_sine_lut_f[x0+1]);
+    return (x0p < k_wt_sine_size)?y0:-y0;
+  }
+
+  /**
+   * Lookup value of cos(2*pi*x). (integer phase version)
+   *
+   * @param   x  Phase, full cycle over 2^32.
+   * @return     Result of cos(2*pi*x).
+   */
+  __fast_inline float osc_cosuf(uint32_t x) {
+    return osc_sinuf(x + (1U<<30));
+  }
+
+  /**
+   * Lookup value of sin(2*pi*x), cubic interpolated. (integer phase version)
+   *
+   * SNR about 136 dB, vs. 85 dB for linear interpolation.
+   *
+   * @param   x  Phase, full cycle over 2^32.
+   * @return     Result of sin(2*pi*x).
+   */
+  __fast_inline float osc_sinhuf(uint32_t x) {
+    return osc_half_hermuf(wt_sine_lut_f, x, -1.f);
+  }
+
+  /**
+   * Lookup value of cos(2*pi*x), cubic interpolated. (integer phase version)
+   *
+   * @param   x  Phase, full cycle over 2^32.
+   * @return     Result of cos(2*pi*x).
+   */
+  __fast_inline float osc_coshuf(uint32_t x) {
+    return osc_sinhuf(x + (1U<<30));
+  }
   
   /** @} */
   
@@ -197,8 +376,6 @@ extern "C" {
   extern const uint8_t wt_saw_notes[k_wt_saw_notes_cnt];
   extern const float wt_saw_lut_f[k_wt_saw_lut_tsize];
 
-  //TODO: add integer phase versions
-  
   /**
    * Sawtooth wave lookup.
    *
@@ -278,6 +455,112 @@ extern "C" {
     return linintf((idx - (uint8_t)idx), y0, y1);
   } 
 
+  /**
+   * Sawtooth wave lookup. (integer phase version)
+   *
+   * @param   x  Phase, full cycle over 2^32.
+   * @return     Wave sample.
+   */
+  __fast_inline float osc_sawuf(uint32_t x) {
+    const uint32_t x0p = x >> k_wt_saw_u32shift;
+    
+    uint32_t x0 = x0p, x1 = x0p+1;
+    float sign = 1.f;
+    if (x0p >= k_wt_saw_size) {
+      x0 = k_wt_saw_size - (x0p & k_wt_saw_mask);
+      x1 = x0 - 1;
+      sign = -1.f;
+    }
+    const float fr = k_wt_saw_frrecip * (float)(x & ((1U<<k_wt_saw_u32shift)-1));
+    return sign * linintf(fr, wt_saw_lut_f[x0], wt_saw_lut_f[x1]);
+  }
+
+  /**
+   * Band-limited sawtooth wave lookup. (integer phase version)
+   *
+   * @param   x     Phase, full cycle over 2^32.
+   * @param   idx   Wave index in [0,6].
+   * @return        Wave sample.
+   */
+  __fast_inline float osc_bl_sawuf(uint32_t x, uint8_t idx) {
+    const uint32_t x0p = x >> k_wt_saw_u32shift;
+    
+    uint32_t x0 = x0p, x1 = x0p+1;
+    float sign = 1.f;
+    if (x0p >= k_wt_saw_size) {
+      x0 = k_wt_saw_size - (x0p & k_wt_saw_mask);
+      x1 = x0 - 1;
+      sign = -1.f;
+    }
+    const float fr = k_wt_saw_frrecip * (float)(x & ((1U<<k_wt_saw_u32shift)-1));
+    const float *wt = &wt_saw_lut_f[idx*k_wt_saw_lut_size];
+    return sign * linintf(fr, wt[x0], wt[x1]);
+  }
+
+  /**
+   * Band-limited sawtooth wave lookup. (integer phase, interpolated version)
+   *
+   * @param   x     Phase, full cycle over 2^32.
+   * @param   idx   Fractional wave index in [0,6].
+   * @return        Wave sample.
+   */
+  __fast_inline float osc_bl2_sawuf(uint32_t x, float idx) {
+    const uint32_t x0p = x >> k_wt_saw_u32shift;
+    
+    uint32_t x0 = x0p, x1 = x0p+1;
+    float sign = 1.f;
+    if (x0p >= k_wt_saw_size) {
+      x0 = k_wt_saw_size - (x0p & k_wt_saw_mask);
+      x1 = x0 - 1;
+      sign = -1.f;
+    }
+    const float fr = k_wt_saw_frrecip * (float)(x & ((1U<<k_wt_saw_u32shift)-1));
+    const float *wt = &wt_saw_lut_f[(uint16_t)idx*k_wt_saw_lut_size];
+    const float y0 = sign * linintf(fr, wt[x0], wt[x1]);
+
+    wt += k_wt_saw_lut_size;
+    const float y1 = sign * linintf(fr, wt[x0], wt[x1]);
+    
+    return linintf((idx - (uint8_t)idx), y0, y1);
+  }
+  /**
+   * Sawtooth wave lookup, cubic interpolated. (integer phase version)
+   *
+   * SNR about 78 dB, vs. 50 dB for linear interpolation.
+   *
+   * @param   x  Phase, full cycle over 2^32.
+   * @return     Wave sample.
+   */
+  __fast_inline float osc_sawhuf(uint32_t x) {
+    return osc_half_hermuf(wt_saw_lut_f, x, -1.f);
+  }
+
+  /**
+   * Band-limited sawtooth wave lookup, cubic interpolated. (integer phase version)
+   *
+   * @param   x     Phase, full cycle over 2^32.
+   * @param   idx   Wave index in [0,6].
+   * @return        Wave sample.
+   */
+  __fast_inline float osc_bl_sawhuf(uint32_t x, uint8_t idx) {
+    return osc_half_hermuf(&wt_saw_lut_f[idx*k_wt_saw_lut_size], x, -1.f);
+  }
+
+  /**
+   * Band-limited sawtooth wave lookup, cubic interpolated. (integer phase, interpolated version)
+   *
+   * @param   x     Phase, full cycle over 2^32.
+   * @param   idx   Fractional wave index in [0,6].
+   * @return        Wave sample.
+   */
+  __fast_inline float osc_bl2_sawhuf(uint32_t x, float idx) {
+    const float *wt = &wt_saw_lut_f[(uint16_t)idx*k_wt_saw_lut_size];
+    const float y0 = osc_half_hermuf(wt, x, -1.f);
+    const float y1 = osc_half_hermuf(wt + k_wt_saw_lut_size, x, -1.f);
+    return linintf((idx - (uint8_t)idx), y0, y1);
+  }
+
+
   /**
    * Get band-limited sawtooth wave index for note.
    *
@@ -393,6 +676,116 @@ extern "C" {
     return linintf((idx - (uint8_t)idx), y0, y1);
   }
   
+  /**
+   * Square wave lookup. (integer phase version)
+   *
+   * @param   x  Phase, full cycle over 2^32.
+   * @return     Wave sample.
+   */
+  __fast_inline float osc_sqruf(uint32_t x) {
+    const uint32_t x0p = x >> k_wt_sqr_u32shift;
+    
+    uint32_t x0 = x0p, x1 = x0p+1;
+    float sign = 1.f;
+    if (x0p >= k_wt_sqr_size) {
+      x0 = k_wt_sqr_size - (x0p & k_wt_sqr_mask);
+      x1 = x0 - 1;
+      sign = -1.f;
+    }
+    const float fr = k_wt_sqr_frrecip * (float)(x & ((1U<<k_wt_sqr_u32shift)-1));
+    return sign * linintf(fr, wt_sqr_lut_f[x0], wt_sqr_lut_f[x1]);
+  }
+
+  /**
+   * Band-limited square wave lookup. (integer phase version)
+   *
+   * @param   x     Phase, full cycle over 2^32.
+   * @param   idx   Wave index in [0,6].
+   * @return        Wave sample.
+   * @note Not checking input, caller responsible for bounding idx.
+   */
+  __fast_inline float osc_bl_sqruf(uint32_t x, uint8_t idx) {
+    const uint32_t x0p = x >> k_wt_sqr_u32shift;
+    
+    uint32_t x0 = x0p, x1 = x0p+1;
+    float sign = 1.f;
+    if (x0p >= k_wt_sqr_size) {
+      x0 = k_wt_sqr_size - (x0p & k_wt_sqr_mask);
+      x1 = x0 - 1;
+      sign = -1.f;
+    }
+    const float fr = k_wt_sqr_frrecip * (float)(x & ((1U<<k_wt_sqr_u32shift)-1));
+    const float *wt = &wt_sqr_lut_f[idx*k_wt_sqr_lut_size];
+    return sign * linintf(fr, wt[x0], wt[x1]);
+  }
+
+  /**
+   * Band-limited square wave lookup. (integer phase, interpolated version)
+   *
+   * @param   x     Phase, full cycle over 2^32.
+   * @param   idx   Fractional wave index in [0,6].
+   * @return        Wave sample.
+   * @note Not checking input, caller responsible for bounding idx.
+   */
+  __fast_inline float osc_bl2_sqruf(uint32_t x, float idx) {
+    const uint32_t x0p = x >> k_wt_sqr_u32shift;
+    
+    uint32_t x0 = x0p, x1 = x0p+1;
+    float sign = 1.f;
+    if (x0p >= k_wt_sqr_size) {
+      x0 = k_wt_sqr_size - (x0p & k_wt_sqr_mask);
+      x1 = x0 - 1;
+      sign = -1.f;
+    }
+    const float fr = k_wt_sqr_frrecip * (float)(x & ((1U<<k_wt_sqr_u32shift)-1));
+    const float *wt = &wt_sqr_lut_f[(uint16_t)idx*k_wt_sqr_lut_size];
+    const float y0 = sign * linintf(fr, wt[x0], wt[x1]);
+
+    wt += k_wt_sqr_lut_size;
+    const float y1 = sign * linintf(fr, wt[x0], wt[x1]);
+    
+    return linintf((idx - (uint8_t)idx), y0, y1);
+  }
+  /**
+   * Square wave lookup, cubic interpolated. (integer phase version)
+   *
+   * SNR about 79 dB, vs. 52 dB for linear interpolation.
+   *
+   * @param   x  Phase, full cycle over 2^32.
+   * @return     Wave sample.
+   */
+  __fast_inline float osc_sqrhuf(uint32_t x) {
+    return osc_half_hermuf(wt_sqr_lut_f, x, -1.f);
+  }
+
+  /**
+   * Band-limited square wave lookup, cubic interpolated. (integer phase version)
+   *
+   * @param   x     Phase, full cycle over 2^32.
+   * @param   idx   Wave index in [0,6].
+   * @return        Wave sample.
+   * @note Not checking input, caller responsible for bounding idx.
+   */
+  __fast_inline float osc_bl_sqrhuf(uint32_t x, uint8_t idx) {
+    return osc_half_hermuf(&wt_sqr_lut_f[idx*k_wt_sqr_lut_size], x, -1.f);
+  }
+
+  /**
+   * Band-limited square wave lookup, cubic interpolated. (integer phase, interpolated version)
+   *
+   * @param   x     Phase, full cycle over 2^32.
+   * @param   idx   Fractional wave index in [0,6].
+   * @return        Wave sample.
+   * @note Not checking input, caller responsible for bounding idx.
+   */
+  __fast_inline float osc_bl2_sqrhuf(uint32_t x, float idx) {
+    const float *wt = &wt_sqr_lut_f[(uint16_t)idx*k_wt_sqr_lut_size];
+    const float y0 = osc_half_hermuf(wt, x, -1.f);
+    const float y1 = osc_half_hermuf(wt + k_wt_sqr_lut_size, x, -1.f);
+    return linintf((idx - (uint8_t)idx), y0, y1);
+  }
+
+
   /**
    * Get band-limited square wave index for note.
    *
@@ -495,6 +888,101 @@ extern "C" {
     return linintf((idx - (uint8_t)idx), y0, y1);
   }
   
+  /**
+   * Parabolic wave lookup. (integer phase version)
+   *
+   * @param   x  Phase, full cycle over 2^32.
+   * @return     Wave sample.
+   */
+  __fast_inline float osc_paruf(uint32_t x) {
+    const uint32_t x0p = x >> k_wt_par_u32shift;
+    
+    const uint32_t x0 = (x0p<=k_wt_par_size) ? x0p : (k_wt_par_size - (x0p & k_wt_par_mask));
+    const uint32_t x1 = (x0p<(k_wt_par_size-1)) ? (x0 + 1) & k_wt_par_mask : (x0p >= k_wt_par_size) ? (x0 - 1) & k_wt_par_mask : (x0 + 1);
+    const float fr = k_wt_par_frrecip * (float)(x & ((1U<<k_wt_par_u32shift)-1));
+    return linintf(fr, wt_par_lut_f[x0], wt_par_lut_f[x1]);
+  }
+
+  /**
+   * Band-limited parabolic wave lookup. (integer phase version)
+   *
+   * @param   x     Phase, full cycle over 2^32.
+   * @param   idx   Wave index in [0,6].
+   * @return        Wave sample.
+   * @note Not checking input, caller responsible for bounding idx.
+   */
+  __fast_inline float osc_bl_paruf(uint32_t x, uint8_t idx) {
+    const uint32_t x0p = x >> k_wt_par_u32shift;
+    
+    const uint32_t x0 = (x0p<=k_wt_par_size) ? x0p : (k_wt_par_size - (x0p & k_wt_par_mask));
+    const uint32_t x1 = (x0p<(k_wt_par_size-1)) ? (x0 + 1) & k_wt_par_mask : (x0p >= k_wt_par_size) ? (x0 - 1) & k_wt_par_mask : (x0 + 1);
+    const float fr = k_wt_par_frrecip * (float)(x & ((1U<<k_wt_par_u32shift)-1));
+    const float *wt = &wt_par_lut_f[idx*k_wt_par_lut_size];
+    return linintf(fr, wt[x0], wt[x1]);
+  }
+
+  /**
+   * Band-limited parabolic wave lookup. (integer phase, interpolated version)
+   *
+   * @param   x     Phase, full cycle over 2^32.
+   * @param   idx   Fractional wave index in [0,6].
+   * @return        Wave sample.
+   * @note Not checking input, caller responsible for bounding idx.
+   */
+  __fast_inline float osc_bl2_paruf(uint32_t x, float idx) {
+    const uint32_t x0p = x >> k_wt_par_u32shift;
+    
+    const uint32_t x0 = (x0p<=k_wt_par_size) ? x0p : (k_wt_par_size - (x0p & k_wt_par_mask));
+    const uint32_t x1 = (x0p<(k_wt_par_size-1)) ? (x0 + 1) & k_wt_par_mask : (x0p >= k_wt_par_size) ? (x0 - 1) & k_wt_par_mask : (x0 + 1);
+    const float fr = k_wt_par_frrecip * (float)(x & ((1U<<k_wt_par_u32shift)-1));
+    const float *wt = &wt_par_lut_f[(uint16_t)idx*k_wt_par_lut_size];
+    const float y0 = linintf(fr, wt[x0], wt[x1]);
+
+    wt += k_wt_par_lut_size;
+    const float y1 = linintf(fr, wt[x0], wt[x1]);
+    
+    return linintf((idx - (uint8_t)idx), y0, y1);
+  }
+  /**
+   * Parabolic wave lookup, cubic interpolated. (integer phase version)
+   *
+   * SNR about 96 dB, vs. 85 dB for linear interpolation.
+   *
+   * @param   x  Phase, full cycle over 2^32.
+   * @return     Wave sample.
+   */
+  __fast_inline float osc_parhuf(uint32_t x) {
+    return osc_half_hermuf(wt_par_lut_f, x, 1.f);
+  }
+
+  /**
+   * Band-limited parabolic wave lookup, cubic interpolated. (integer phase version)
+   *
+   * @param   x     Phase, full cycle over 2^32.
+   * @param   idx   Wave index in [0,6].
+   * @return        Wave sample.
+   * @note Not checking input, caller responsible for bounding idx.
+   */
+  __fast_inline float osc_bl_parhuf(uint32_t x, uint8_t idx) {
+    return osc_half_hermuf(&wt_par_lut_f[idx*k_wt_par_lut_size], x, 1.f);
+  }
+
+  /**
+   * Band-limited parabolic wave lookup, cubic interpolated. (integer phase, interpolated version)
+   *
+   * @param   x     Phase, full cycle over 2^32.
+   * @param   idx   Fractional wave index in [0,6].
+   * @return        Wave sample.
+   * @note Not checking input, caller responsible for bounding idx.
+   */
+  __fast_inline float osc_bl2_parhuf(uint32_t x, float idx) {
+    const float *wt = &wt_par_lut_f[(uint16_t)idx*k_wt_par_lut_size];
+    const float y0 = osc_half_hermuf(wt, x, 1.f);
+    const float y1 = osc_half_hermuf(wt + k_wt_par_lut_size, x, 1.f);
+    return linintf((idx - (uint8_t)idx), y0, y1);
+  }
+
+
   /**
    * Get band-limited parabolic wave index for note.
    *
@@ -522,8 +1010,8 @@ extern "C" {
 
 #define k_waves_size_exp   (7)
 #define k_waves_size       (1U<<k_waves_size_exp)
-#define k_waves_u32shift   (24)
-#define k_waves_frrecip    (5.96046447753906e-008f) // 1/(1<<24)
+#define k_waves_u32shift   (25)
+#define k_waves_frrecip    (2.98023223876953e-008f) // 1/(1<<25)
 #define k_waves_mask       (k_waves_size-1)
 #define k_waves_lut_size   (k_waves_size+1)
   
@@ -567,6 +1055,388 @@ extern "C" {
     const float fr = k_waves_frrecip * (float)(x & ((1U<<k_waves_u32shift)-1));
     return linintf(fr, w[x0], w[x1]);
   }
+
+  /**
+   * Scan a wave, cubic interpolated. (integer phase version)
+   *
+   * SNR about 54 dB, vs. 39 dB for linear interpolation.
+   *
+   * @param   w  Wave.
+   * @param   x  Phase, full cycle over 2^32.
+   * @return     Wave sample.
+   */
+  static inline __attribute__((always_inline, optimize("Ofast")))
+  float osc_wave_scanhuf(const float *w, uint32_t x) {
+    const uint32_t x0 = (x>>k_waves_u32shift);
+    const float fr = k_waves_frrecip * (float)(x & ((1U<<k_waves_u32shift)-1));
+    return hermintf(fr, w[(x0 - 1) & k_waves_mask], w[x0], w[(x0 + 1) & k_waves_mask], w[(x0 + 2) & k_waves_mask]);
+  }
+
+  /**
+   * Scan a wave over a block of samples, with linearly ramped phase increment.
+   *
+   * @param   out     Output buffer.
+   * @param   frames  Number of samples to render.
+   * @param   w       Wave.
+   * @param   x       Phase of first sample, full cycle over 2^32.
+   * @param   w0      Phase increment at first sample, full cycle over 2^32.
+   * @param   w1      Phase increment at end of block, full cycle over 2^32.
+   * @return          Phase following the last rendered sample, x if frames is 0.
+   */
+  static inline __attribute__((optimize("Ofast")))
+  uint32_t osc_wave_scanuf_buf(float * __restrict__ out, uint32_t frames, const float *w,
+                               uint32_t x, uint32_t w0, uint32_t w1) {
+    if (!frames)
+      return x;
+    const int32_t dw = ((int32_t)(w1 - w0)) / (int32_t)frames;
+    const float * out_e = out + frames;
+    for (; out != out_e; ) {
+      const uint32_t x0 = (x>>k_waves_u32shift);
+      const uint32_t x1 = (x0 + 1) & k_waves_mask;
+      const float fr = k_waves_frrecip * (float)(x & ((1U<<k_waves_u32shift)-1));
+      *(out++) = linintf(fr, w[x0], w[x1]);
+      x += w0;
+      w0 += dw;
+    }
+    return x;
+  }
+
+  /**
+   * Scan and crossfade two waves over a block of samples, with linearly ramped mix.
+   *
+   * @param   out     Output buffer.
+   * @param   frames  Number of samples to render.
+   * @param   wa      First wave.
+   * @param   wb      Second wave.
+   * @param   xa      Phase of first wave, updated to phase following the last rendered sample.
+   * @param   xb      Phase of second wave, updated to phase following the last rendered sample.
+   * @param   wa_inc  Phase increment of first wave, full cycle over 2^32.
+   * @param   wb_inc  Phase increment of second wave, full cycle over 2^32.
+   * @param   mix0    Mix at first sample, 0 for first wave only, 1 for second wave only.
+   * @param   mix1    Mix at end of block.
+   */
+  static inline __attribute__((optimize("Ofast")))
+  void osc_wave_xfade_scanuf_buf(float * __restrict__ out, uint32_t frames,
+                                 const float *wa, const float *wb,
+                                 uint32_t *xa, uint32_t *xb,
+                                 uint32_t wa_inc, uint32_t wb_inc,
+                                 float mix0, float mix1) {
+    const float dmix = (mix1 - mix0) / frames;
+    uint32_t pa = *xa, pb = *xb;
+    const float * out_e = out + frames;
+    for (; out != out_e; ) {
+      const uint32_t a0 = (pa>>k_waves_u32shift);
+      const uint32_t a1 = (a0 + 1) & k_waves_mask;
+      const float fra = k_waves_frrecip * (float)(pa & ((1U<<k_waves_u32shift)-1));
+      const uint32_t b0 = (pb>>k_waves_u32shift);
+      const uint32_t b1 = (b0 + 1) & k_waves_mask;
+      const float frb = k_waves_frrecip * (float)(pb & ((1U<<k_waves_u32shift)-1));
+      const float ya = linintf(fra, wa[a0], wa[a1]);
+      const float yb = linintf(frb, wb[b0], wb[b1]);
+      *(out++) = linintf(mix0, ya, yb);
+      pa += wa_inc;
+      pb += wb_inc;
+      mix0 += dmix;
+    }
+    *xa = pa;
+    *xb = pb;
+  }
+  
+  /** @} */
+  
+  /*===========================================================================*/
+  /* Wave registry                                                             */
+  /*===========================================================================*/
+  /**
+   * @name   Wave registry.
+   *
+   * Presents the six wave banks as a single flat index over all k_waves_cnt waves, bank A first, e.g.: index
+   * k_waves_d_ofs + 2 is wavesD[2]. Lookups are constant time and branch free.
+   *
+   * An osc_wave_bank_t additionally carries a brightness figure per wave, and the waves ordered by brightness, so
+   * that a unit can select a wave for a given brightness or pitch, and morph between neighbouring waves with
+   * osc_wave_morph_scanuf_buf(). The wave data lives in firmware, so the metadata is computed once by
+   * osc_wave_bank_init(), typically from OSC_INIT(), at a cost of a few hundred operations per wave.
+   *
+   * @{ 
+   */
+
+#define k_waves_a_ofs       (0)
+#define k_waves_b_ofs       (k_waves_a_ofs + k_waves_a_cnt)
+#define k_waves_c_ofs       (k_waves_b_ofs + k_waves_b_cnt)
+#define k_waves_d_ofs       (k_waves_c_ofs + k_waves_c_cnt)
+#define k_waves_e_ofs       (k_waves_d_ofs + k_waves_d_cnt)
+#define k_waves_f_ofs       (k_waves_e_ofs + k_waves_e_cnt)
+#define k_waves_cnt         (k_waves_f_ofs + k_waves_f_cnt)
+
+  /**
+   * Get wave by flat index.
+   *
+   * @param idx Index in [0, k_waves_cnt-1] range, see k_waves_*_ofs for the first wave of each bank.
+   * @return    Wave.
+   */
+  __fast_inline const float * osc_wave_get(uint32_t idx) {
+    static const float * const * const banks[6] = { wavesA, wavesB, wavesC, wavesD, wavesE, wavesF };
+    static const uint8_t ofs[6] = { k_waves_a_ofs, k_waves_b_ofs, k_waves_c_ofs,
+                                    k_waves_d_ofs, k_waves_e_ofs, k_waves_f_ofs };
+    const uint32_t bank = (idx >= k_waves_b_ofs) + (idx >= k_waves_c_ofs) + (idx >= k_waves_d_ofs)
+      + (idx >= k_waves_e_ofs) + (idx >= k_waves_f_ofs);
+    return banks[bank][idx - ofs[bank]];
+  }
+
+  /**
+   * Measure brightness of a wave.
+   *
+   * Ratio of the RMS of the wave's derivative over the RMS of the wave itself, DC excluded, scaled so that a
+   * pure k-th harmonic measures about k. Equivalent to the RMS harmonic number of the spectrum, i.e.: sqrt of the
+   * power weighted mean of squared harmonic numbers. Reads low for upper harmonics, e.g.: 28.8 for k = 32.
+   *
+   * @param w Wave.
+   * @return  Brightness, 0 for a silent or constant wave.
+   */
+  static inline __attribute__((optimize("Ofast")))
+  float osc_wave_brightnessf(const float *w) {
+    float sum = 0.f;
+    for (uint32_t i = 0; i < k_waves_size; ++i)
+      sum += w[i];
+    const float dc = sum * (1.f / k_waves_size);
+    float pw = 0.f, pd = 0.f;
+    float prev = w[k_waves_size - 1];
+    for (uint32_t i = 0; i < k_waves_size; ++i) {
+      const float x = w[i];
+      const float d = x - prev;
+      pw += (x - dc) * (x - dc);
+      pd += d * d;
+      prev = x;
+    }
+    if (pw <= 1e-12f)
+      return 0.f;
+    return sqrtf(pd / pw) * (float)(k_waves_size / (2.0 * M_PI));
+  }
+  
+  /**
+   * Wave registry metadata, see osc_wave_bank_init().
+   */
+  typedef struct osc_wave_bank {
+    float   brightness[k_waves_cnt];  ///< Brightness of each wave in order, ascending
+    uint8_t order[k_waves_cnt];       ///< Flat wave indexes, by ascending brightness
+  } osc_wave_bank_t;
+
+  /**
+   * Compute brightness metadata of all waves. 
+   *
+   * @param b Registry metadata.
+   */
+  static inline __attribute__((optimize("Ofast")))
+  void osc_wave_bank_init(osc_wave_bank_t *b) {
+    // Insertion sort, stable so that equally bright waves keep their bank order
+    for (uint32_t i = 0; i < k_waves_cnt; ++i) {
+      const float br = osc_wave_brightnessf(osc_wave_get(i));
+      uint32_t j = i;
+      for (; j > 0 && b->brightness[j-1] > br; --j) {
+        b->brightness[j] = b->brightness[j-1];
+        b->order[j] = b->order[j-1];
+      }
+      b->brightness[j] = br;
+      b->order[j] = i;
+    }
+  }
+
+  /**
+   * Find the position of the brightest wave not brighter than given brightness.
+   *
+   * For pitch dependent selection, a wave of brightness b played at phase increment w0 (in [0-1) range) has its
+   * spectral centroid around b * w0 * k_samplerate, so e.g.: osc_wave_bank_find(b, 0.1f / w0) keeps it under
+   * 4.8 kHz.
+   *
+   * @param b          Registry metadata.
+   * @param brightness Brightness.
+   * @return           Position in the brightness order in [0, k_waves_cnt-1], 0 if all waves are brighter.
+   */
+  __fast_inline uint32_t osc_wave_bank_find(const osc_wave_bank_t *b, float brightness) {
+    uint32_t lo = 0, n = k_waves_cnt;
+    while (n > 1) {
+      const uint32_t half = n >> 1;
+      lo = (b->brightness[lo + half] <= brightness) ? lo + half : lo;
+      n -= half;
+    }
+    return lo;
+  }
+
+  /**
+   * Get wave by position in the brightness order.
+   *
+   * @param b   Registry metadata.
+   * @param pos Position in [0, k_waves_cnt-1] range, 0 being the darkest wave.
+   * @return    Wave.
+   */
+  __fast_inline const float * osc_wave_bank_get(const osc_wave_bank_t *b, uint32_t pos) {
+    return osc_wave_get(b->order[pos]);
+  }
+
+  /**
+   * Scan and morph two waves sharing the same phase over a block of samples, with linearly ramped mix.
+   *
+   * Unlike osc_wave_xfade_scanuf_buf() the interpolation index and fraction are computed once for both waves,
+   * meant for morphing between neighbours in the brightness order, e.g.: for fractional position p,
+   * osc_wave_bank_get(b, (uint32_t)p) and the following wave, mixed by the fractional part of p.
+   *
+   * @param   out     Output buffer.
+   * @param   frames  Number of samples to render.
+   * @param   wa      First wave.
+   * @param   wb      Second wave.
+   * @param   x       Phase of first sample, full cycle over 2^32.
+   * @param   w0      Phase increment, full cycle over 2^32.
+   * @param   mix0    Mix at first sample, 0 for first wave only, 1 for second wave only.
+   * @param   mix1    Mix at end of block.
+   * @return          Phase following the last rendered sample.
+   */
+  static inline __attribute__((optimize("Ofast")))
+  uint32_t osc_wave_morph_scanuf_buf(float * __restrict__ out, uint32_t frames,
+                                     const float *wa, const float *wb,
+                                     uint32_t x, uint32_t w0,
+                                     float mix0, float mix1) {
+    const float dmix = (mix1 - mix0) / frames;
+    const float * out_e = out + frames;
+    for (; out != out_e; ) {
+      const uint32_t x0 = (x>>k_waves_u32shift);
+      const uint32_t x1 = (x0 + 1) & k_waves_mask;
+      const float fr = k_waves_frrecip * (float)(x & ((1U<<k_waves_u32shift)-1));
+      const float y0 = linintf(mix0, wa[x0], wb[x0]);
+      const float y1 = linintf(mix0, wa[x1], wb[x1]);
+      *(out++) = linintf(fr, y0, y1);
+      x += w0;
+      mix0 += dmix;
+    }
+    return x;
+  }
+  
+  /** @} */
+  
+  /*===========================================================================*/
+  /* Compressed waves                                                          */
+  /*===========================================================================*/
+  /**
+   * @name   Compressed waves.
+   *
+   * Compact storage for custom waves in wave bank layout, k_waves_size points over a full cycle, for units that
+   * would otherwise exhaust their SRAM with float tables. Samples are signed integers with a per wave scale factor.
+   * See tools/wavetable for a converter.
+   *
+   * | Format           | Bytes per wave  | SNR (pre-interpolation) |
+   * |------------------|-----------------|-------------------------|
+   * | float            | 516 (with guard)| -                       |
+   * | osc_wave_s12_t   | 196             | about 72 dB             |
+   * | osc_wave_s8_t    | 132             | about 48 dB             |
+   *
+   * Waves can either be decoded to a float buffer of k_waves_lut_size when selected, e.g.: on parameter change,
+   * and scanned with the regular float wave functions, or scanned directly at a small extra cost per sample.
+   *
+   * @{ 
+   */
+
+  /**
+   * 8-bit compressed wave.
+   */
+  typedef struct osc_wave_s8 {
+    float  scale;                  ///< Scale to apply to samples
+    int8_t data[k_waves_size];     ///< Samples
+  } osc_wave_s8_t;
+
+  /**
+   * 12-bit compressed wave. Samples are packed in pairs over 3 bytes, lower bits first.
+   */
+  typedef struct osc_wave_s12 {
+    float   scale;                 ///< Scale to apply to samples
+    uint8_t data[3*k_waves_size/2];  ///< Packed samples
+  } osc_wave_s12_t;
+
+  /**
+   * Raw sample of 8-bit compressed wave.
+   *
+   * @param   w  Wave.
+   * @param   i  Sample index in [0, k_waves_size-1].
+   * @return     Raw sample, in [-128, 127].
+   */
+  static inline __attribute__((always_inline, optimize("Ofast")))
+  int32_t osc_wave_s8_get(const osc_wave_s8_t *w, uint32_t i) {
+    return w->data[i];
+  }
+
+  /**
+   * Raw sample of 12-bit compressed wave.
+   *
+   * @param   w  Wave.
+   * @param   i  Sample index in [0, k_waves_size-1].
+   * @return     Raw sample, in [-2048, 2047].
+   */
+  static inline __attribute__((always_inline, optimize("Ofast")))
+  int32_t osc_wave_s12_get(const osc_wave_s12_t *w, uint32_t i) {
+    const uint8_t *p = w->data + 3*(i>>1);
+    const uint32_t u = (i & 1) ? ((p[1] >> 4) | ((uint32_t)p[2] << 4)) : (p[0] | ((uint32_t)(p[1] & 0x0F) << 8));
+    return ((int32_t)(u << 20)) >> 20;
+  }
+
+  /**
+   * Decode 8-bit compressed wave for use with float wave functions.
+   *
+   * @param   out  Output buffer, k_waves_lut_size samples.
+   * @param   w    Wave.
+   */
+  static inline __attribute__((optimize("Ofast")))
+  void osc_wave_s8_decode(float * __restrict__ out, const osc_wave_s8_t *w) {
+    const float scale = w->scale;
+    for (uint32_t i = 0; i < k_waves_size; ++i)
+      out[i] = scale * w->data[i];
+    out[k_waves_size] = out[0];
+  }
+
+  /**
+   * Decode 12-bit compressed wave for use with float wave functions.
+   *
+   * @param   out  Output buffer, k_waves_lut_size samples.
+   * @param   w    Wave.
+   */
+  static inline __attribute__((optimize("Ofast")))
+  void osc_wave_s12_decode(float * __restrict__ out, const osc_wave_s12_t *w) {
+    const float scale = w->scale;
+    const uint8_t *p = w->data;
+    for (uint32_t i = 0; i < k_waves_size; i += 2, p += 3) {
+      out[i]   = scale * (((int32_t)(((uint32_t)p[0] | ((uint32_t)p[1] << 8)) << 20)) >> 20);
+      out[i+1] = scale * (((int32_t)(((uint32_t)p[1] | ((uint32_t)p[2] << 8)) << 16)) >> 20);
+    }
+    out[k_waves_size] = out[0];
+  }
+
+  /**
+   * Scan an 8-bit compressed wave. (integer phase version)
+   *
+   * @param   w  Wave.
+   * @param   x  Phase, full cycle over 2^32.
+   * @return     Wave sample.
+   */
+  static inline __attribute__((always_inline, optimize("Ofast")))
+  float osc_wave_s8_scanuf(const osc_wave_s8_t *w, uint32_t x) {
+    const uint32_t x0 = (x>>k_waves_u32shift);
+    const uint32_t x1 = (x0 + 1) & k_waves_mask;
+    const float fr = k_waves_frrecip * (float)(x & ((1U<<k_waves_u32shift)-1));
+    return w->scale * linintf(fr, (float)w->data[x0], (float)w->data[x1]);
+  }
+
+  /**
+   * Scan a 12-bit compressed wave. (integer phase version)
+   *
+   * @param   w  Wave.
+   * @param   x  Phase, full cycle over 2^32.
+   * @return     Wave sample.
+   */
+  static inline __attribute__((always_inline, optimize("Ofast")))
+  float osc_wave_s12_scanuf(const osc_wave_s12_t *w, uint32_t x) {
+    const uint32_t x0 = (x>>k_waves_u32shift);
+    const uint32_t x1 = (x0 + 1) & k_waves_mask;
+    const float fr = k_waves_frrecip * (float)(x & ((1U<<k_waves_u32shift)-1));
+    return w->scale * linintf(fr, (float)osc_wave_s12_get(w, x0), (float)osc_wave_s12_get(w, x1));
+  }
   
   /** @} */
   
@@ -689,7 +1559,7 @@ extern "C" {
    */
   __fast_inline float osc_sat_cubicf(float x) {
     const float xf = si_fabsf(clip1f(x)) * k_cubicsat_size;
-    const uint32_t xi = (uint32_t)x;
+    const uint32_t xi = clipmaxu32((uint32_t)xf, k_cubicsat_size - 1);
     const float y0 = cubicsat_lut_f[xi];
     const float y1 = cubicsat_lut_f[xi+1];
     return si_copysignf(linintf(xf - xi, y0, y1), x);
@@ -710,7 +1580,7 @@ extern "C" {
    */
   __fast_inline float osc_sat_schetzenf(float x) {
     const float xf = si_fabsf(clip1f(x)) * k_schetzen_size;
-    const uint32_t xi = (uint32_t)x;
+    const uint32_t xi = clipmaxu32((uint32_t)xf, k_schetzen_size - 1);
     const float y0 = schetzen_lut_f[xi];
     const float y1 = schetzen_lut_f[xi+1];
     return si_copysignf(linintf(xf - xi, y0, y1), x);
@@ -0,0 +1,91 @@
+/*
+ * File: unison.cpp
+ *
+ * Simple runtime test using Unison class in stereo with a CPU budget
+ *
+ * 
+ * 
+ * 2018 (c) Korg
+ *
+ */
+
+#include "usermodfx.h"
+
+#include "unison.hpp"
+#include "polyblep.hpp"
+
+static dsp::Unison<16> s_unison;
+
+enum {
+  k_block_size = 64
+};
+
+enum {
+  // Rough per sub-voice cost of the PolyBLEP saw kernel, in cycles per sample
+  k_voice_cost = 40,
+  k_budget_max = 16 * k_voice_cost
+};
+
+static uint32_t s_budget;
+static float s_spread;
+
+void MODFX_INIT(uint32_t platform, uint32_t api)
+{
+  s_unison = dsp::Unison<16>();
+  s_unison.setW0((uint32_t)(110.f / 48000.f * 4294967296.f));
+  s_unison.setDetune(0.5f);
+  s_unison.reset(0x5EED);
+  s_budget = k_budget_max;
+  s_spread = 1.f;
+}
+
+void MODFX_PROCESS(const float *main_xn, float *main_yn,
+                   const float *sub_xn,  float *sub_yn,
+                   uint32_t frames)
+{
+  float * __restrict my = main_yn;
+  const float * my_e = my + 2*frames;
+  float * __restrict sy = sub_yn;
+
+  // Voice count and gains are only updated at block boundaries.
+  s_unison.setVoiceBudget(s_budget, k_voice_cost);
+  s_unison.setSpread(s_spread);
+  
+  const dsp::PolyBLEPOsc::Kernel<dsp::PolyBLEPOsc::k_wave_saw> saw;
+  
+  // Interleaved as left, right
+  float wave_buf[2 * k_block_size];
+  
+  for (; my != my_e; ) {
+    const uint32_t remaining = (my_e - my) >> 1;
+    const uint32_t count = (remaining < k_block_size) ? remaining : k_block_size;
+    
+    s_unison.renderStereo(saw, wave_buf, count);
+
+    const float *w = wave_buf;
+    const float *w_e = w + 2 * count;
+    for (; w != w_e; w += 2) {
+      // Scale down the wave, full swing is way too loud. (polyphony headroom)
+      *(my++) = 0.1f * w[0];
+      *(my++) = 0.1f * w[1];
+      *(sy++) = 0.1f * w[0];
+      *(sy++) = 0.1f * w[1];
+    }
+  }
+}
+
+
+void MODFX_PARAM(uint8_t index, int32_t value)
+{
+  const float valf = q31_to_f32(value);
+  switch (index) {
+  case k_user_modfx_param_time:
+    s_budget = si_roundf(valf * k_budget_max);
+    break;
+  case k_user_modfx_param_depth:
+    s_spread = valf;
+    break;
+  default:
+    break;
+  }
+}
@@ -0,0 +1,139 @@
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+/*
+ * File: hardsync.cpp
+ *
+ * Hard sync test
+ *
+ */
+
+#include "userosc.h"
+
+#include "hardsync.hpp"
+
+enum {
+  k_block_size = 64
+};
+
+struct WaveA {
+  WaveA(const float *w) : wave(w) { }
+  
+  inline __attribute__((optimize("Ofast"),always_inline))
+  float operator()(const uint32_t phi) const
+  {
+    return osc_wave_scanuf(wave, phi);
+  }
+  
+  const float *wave;
+};
+
+typedef struct State {
+  dsp::HardSync osc;
+  float ratio;
+  uint8_t wave;
+} State;
+
+static State s_state;
+
+void OSC_INIT(uint32_t platform, uint32_t api)
+{
+  s_state.osc = dsp::HardSync();
+  s_state.ratio = 1.f;
+  s_state.wave = 0;
+}
+
+void OSC_CYCLE(const user_osc_param_t * const params,
+               int32_t *yn,
+               const uint32_t frames)
+{
+  dsp::HardSync &osc = s_state.osc;
+  
+  // Slave ratio swept by shape LFO
+  const float w0 = osc_w0f_for_pitch(params->pitch);
+  const float ratio = clipminmaxf(1.f, s_state.ratio + 2.f * q31_to_f32(params->shape_lfo), 8.f);
+  osc.setMasterW0((uint32_t)(w0 * 4294967296.f));
+  osc.setW0((uint32_t)(clipmaxf(w0 * ratio, 0.49f) * 4294967296.f));
+  
+  const WaveA wave(wavesA[s_state.wave]);
+  float buf[k_block_size];
+  
+  q31_t * __restrict y = (q31_t *)yn;
+  const q31_t * y_e = y + frames;
+  
+  for (; y != y_e; ) {
+    const uint32_t remaining = y_e - y;
+    const uint32_t count = (remaining < k_block_size) ? remaining : k_block_size;
+
+    osc.render(buf, count, wave);
+    
+    const float *b = buf;
+    const q31_t *yc_e = y + count;
+    for (; y != yc_e; )
+      *(y++) = f32_to_q31(0.5f * *(b++));
+  }
+}
+
+void OSC_NOTEON(const user_osc_param_t * const params)
+{
+  s_state.osc.resetPhase();
+}
+
+void OSC_NOTEOFF(const user_osc_param_t * const params)
+{
+  (void)params;
+}
+
+void OSC_PARAM(uint16_t index, uint16_t value)
+{
+  const float valf = param_val_to_f32(value);
+  
+  switch (index) {
+  case k_user_osc_param_id1:
+  case k_user_osc_param_id2:
+  case k_user_osc_param_id3:
+  case k_user_osc_param_id4:
+  case k_user_osc_param_id5:
+  case k_user_osc_param_id6:
+    break;
+  case k_user_osc_param_shape:
+    // Slave to master ratio
+    s_state.ratio = 1.f + 7.f * valf;
+    break;
+  case k_user_osc_param_shiftshape:
+    s_state.wave = (uint8_t)(valf * (k_waves_a_cnt - 1) + 0.5f);
+    break;
+  default:
+    break;
+  }
+}
@@ -0,0 +1,133 @@
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+/*
+ * File: shaper.cpp
+ *
+ * Oversampled phase distortion and wavefolder test
+ *
+ */
+
+#include "userosc.h"
+
+#include "shaper.hpp"
+
+enum {
+  k_block_size = 64
+};
+
+typedef dsp::Shaper<dsp::k_shaper_2x> Shaper;
+
+typedef struct State {
+  Shaper pd;
+  Shaper folder;
+  uint32_t phi;
+  float drive;
+  float amount;
+} State;
+
+static State s_state;
+
+void OSC_INIT(uint32_t platform, uint32_t api)
+{
+  s_state.pd = Shaper();
+  s_state.folder = Shaper();
+  s_state.phi = 0;
+  s_state.drive = 1.f;
+  s_state.amount = 0.f;
+}
+
+void OSC_CYCLE(const user_osc_param_t * const params,
+               int32_t *yn,
+               const uint32_t frames)
+{
+  // Phase distortion oscillator into wavefolder
+  const uint32_t w = osc_w0u_for_pitch(params->pitch);
+  const float amount = clip01f(s_state.amount + q31_to_f32(params->shape_lfo));
+  const float drive = s_state.drive;
+  
+  float buf[k_block_size];
+  uint32_t phi = s_state.phi;
+  
+  q31_t * __restrict y = (q31_t *)yn;
+  const q31_t * y_e = y + frames;
+  
+  for (; y != y_e; ) {
+    const uint32_t remaining = y_e - y;
+    const uint32_t count = (remaining < k_block_size) ? remaining : k_block_size;
+
+    s_state.pd.pd(buf, count, phi, w, amount);
+    s_state.folder.fold(buf, count, drive);
+    
+    const float *b = buf;
+    const q31_t *yc_e = y + count;
+    for (; y != yc_e; )
+      *(y++) = f32_to_q31(0.5f * *(b++));
+  }
+  
+  s_state.phi = phi;
+}
+
+void OSC_NOTEON(const user_osc_param_t * const params)
+{
+  (void)params;
+}
+
+void OSC_NOTEOFF(const user_osc_param_t * const params)
+{
+  (void)params;
+}
+
+void OSC_PARAM(uint16_t index, uint16_t value)
+{
+  const float valf = param_val_to_f32(value);
+  
+  switch (index) {
+  case k_user_osc_param_id1:
+  case k_user_osc_param_id2:
+  case k_user_osc_param_id3:
+  case k_user_osc_param_id4:
+  case k_user_osc_param_id5:
+  case k_user_osc_param_id6:
+    break;
+  case k_user_osc_param_shape:
+    s_state.amount = valf;
+    break;
+  case k_user_osc_param_shiftshape:
+    // Fold drive from 1 (soft saturation only) to 8
+    s_state.drive = 1.f + 7.f * valf;
+    break;
+  default:
+    break;
+  }
+}
@@ -17,14 +17,15 @@ static dsp::DelayLine s_delay;
 
 static __sdram float s_delay_ram[48000];
 
-static float s_len_z, s_len;
+static float s_len;
 static float s_mix;
 static const float s_fs_recip = 1.f / 48000.f;
 
 void REVFX_INIT(uint32_t platform, uint32_t api)
 {
   s_delay.setMemory(s_delay_ram, 48000);  
-  s_len = s_len_z = 1.f;
+  s_delay.setXfadeLength(2400); // 50ms
+  s_len = 1.f;
   s_mix = 1.f;
 }
 
@@ -33,8 +34,7 @@ void REVFX_PROCESS(float *xn, uint32_t frames)
   float * __restrict x = xn;
   const float * x_e = x + 2*frames;
   
-  const float len = s_len;
-  float len_z = s_len_z;
+  s_delay.updateXfade(s_len, frames);
 
   const float dry = 1.f - s_mix;
   const float wet = s_mix;
@@ -43,14 +43,10 @@ void REVFX_PROCESS(float *xn, uint32_t frames)
     
     *(x++);
     
-    len_z = linintf(0.00004f, len_z, len);
-    
-    const float r = 0.25f * s_delay.readFrac(len_z);
+    const float r = 0.25f * s_delay.readXfade();
     s_delay.write(*x);
     *(x++) = dry * (*x) + wet * r;
   }
-
-  s_len_z = len_z;
 }
 
 
@@ -31,6 +31,10 @@ enum {
   k_wave_count
 };
 
+enum {
+  k_block_size = 64
+};
+
 static uint8_t s_lfo_wave;
 static float s_param_z, s_param;
 static const float s_fs_recip = 1.f / 48000.f;
@@ -46,75 +50,31 @@ void REVFX_PROCESS(float *xn, uint32_t frames)
   float * __restrict x = xn;
   const float * x_e = x + 2*frames;
 
-  const float p = s_param;
-  float p_z = s_param_z;
+  // Select waveform specialization once per block.
+  // Note: wave enum is laid out as 4 bipolar, 4 unipolar then 4 bipolar with offset waves.
+  const uint8_t sel = s_lfo_wave;
+  const dsp::SimpleLFO::RenderFunc render =
+    dsp::SimpleLFO::renderFunc(sel & 0x3, (sel >> 2) == 1, (sel >> 2) == 2);
+  
+  float wave_buf[k_block_size];
   
   for (; x != x_e; ) {
-
-    p_z = linintf(0.002f, p_z, p);
-    
-    s_lfo.cycle();
+    const uint32_t remaining = (x_e - x) >> 1;
+    const uint32_t count = (remaining < k_block_size) ? remaining : k_block_size;
     
-    float wave;
-    
-    switch (s_lfo_wave) {
-    case k_sin:
-      wave = s_lfo.sine_bi();
-      break;
-      
-    case k_tri:
-      wave = s_lfo.triangle_bi();
-      break;
-      
-    case k_saw:
-      wave = s_lfo.saw_bi();
-      break;
-      
-    case k_sqr:
-      wave = s_lfo.square_bi();
-      break;
-      
-    case k_sin_uni:
-      wave = s_lfo.sine_uni();
-      break;
-
-    case k_tri_uni:
-      wave = s_lfo.triangle_uni();
-      break;
-
-    case k_saw_uni:
-      wave = s_lfo.saw_uni();
-      break;
-
-    case k_sqr_uni:
-      wave = s_lfo.square_uni();
-      break;
-
-    case k_sin_off:
-      wave = s_lfo.sine_bi_off(s_param_z);
-      break;
-
-    case k_tri_off:
-      wave = s_lfo.triangle_bi_off(s_param_z);
-      break;
-
-    case k_saw_off:
-      wave = s_lfo.saw_bi_off(s_param_z);
-      break;
-
-    case k_sqr_off:
-      wave = s_lfo.square_bi_off(s_param_z);
-      break;
+    (s_lfo.*render)(wave_buf, count, s_param_z);
+
+    const float *w = wave_buf;
+    const float *w_e = w + count;
+    for (; w != w_e; ) {
+      // Scale down the wave, full swing is way too loud. (polyphony headroom)
+      const float wave = 0.025f * *(w++);
+      *(x++) += wave;
+      *(x++) += wave;
     }
-    
-    // Scale down the wave, full swing is way too loud. (polyphony headroom)
-    wave *= 0.025f;
-    
-    *(x++) += wave;
-    *(x++) += wave;
   }
 
-  s_param_z = p_z;
+  s_param_z = linintf(clip1f(0.002f * frames), s_param_z, s_param);
 }
 
 
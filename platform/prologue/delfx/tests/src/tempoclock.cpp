@@ -0,0 +1,107 @@
+/*
+ * File: tempoclock.cpp
+ *
+ * Test tempo synced delay and tremolo driven by a TempoClock
+ *
+ * Time selects the note division, depth the tremolo depth on the delayed signal and shift-depth the dry/wet mix.
+ *
+ * 2018 (c) Korg
+ *
+ */
+
+#include "userdelfx.h"
+
+#include "tempoclock.hpp"
+#include "simplelfo.hpp"
+#include "delayline.hpp"
+
+enum {
+  k_delay_size = 0x10000 // power of two, about 1.36s
+};
+
+static dsp::TempoClock s_clock;
+static dsp::SimpleLFO s_lfo;
+static dsp::DelayLine s_delay;
+
+static __sdram float s_delay_ram[k_delay_size];
+
+static float s_len;
+static float s_depth;
+static float s_mix;
+static uint8_t s_div_z, s_div;
+
+void DELFX_INIT(uint32_t platform, uint32_t api)
+{
+  s_clock = dsp::TempoClock();
+  s_clock.setSampleRate(48000);
+  s_lfo.reset();
+  s_delay.setMemory(s_delay_ram, k_delay_size);
+  s_delay.setXfadeLength(2400); // 50ms
+  s_len = 24000.f;
+  s_depth = 0.f;
+  s_mix = 0.5f;
+  s_div_z = s_div = dsp::TempoClock::k_div_1_4;
+}
+
+void DELFX_PROCESS(float *xn, uint32_t frames)
+{
+  float * __restrict x = xn;
+  const float * x_e = x + 2*frames;
+
+  // Tempo and division are only checked at block boundaries, the clock recomputes increments on change.
+  if (s_div_z != s_div) {
+    s_div_z = s_div;
+    s_clock.setDivision(s_div_z);
+  }
+  s_clock.update(fx_get_bpm());
+
+  // Phase is derived from beat position, no drift across blocks.
+  s_lfo.setPhaseU32(s_clock.phase(), s_clock.w0());
+
+  // Keep last delay time while tempo is unknown, fold long divisions down by octaves to fit in memory.
+  float len = s_clock.periodSamples();
+  if (len > 0.f) {
+    while (len > k_delay_size - 2)
+      len *= 0.5f;
+    s_len = len;
+  }
+  s_delay.updateXfade(s_len, frames);
+
+  const float dry = 1.f - s_mix;
+  const float wet = s_mix;
+  const float depth = s_depth;
+
+  for (; x != x_e; x += 2) {
+    // Tremolo peaks on division boundaries
+    const float g = 1.f - depth * (1.f - s_lfo.triangle_uni());
+    s_lfo.cycle();
+
+    const float r = s_delay.readXfade();
+    s_delay.write(0.5f * (x[0] + x[1]) + 0.5f * r);
+
+    const float w = wet * g * r;
+    x[0] = dry * x[0] + w;
+    x[1] = dry * x[1] + w;
+  }
+
+  s_clock.advance(frames);
+}
+
+
+void DELFX_PARAM(uint8_t index, int32_t value)
+{
+  const float valf = q31_to_f32(value);
+  switch (index) {
+  case k_user_delfx_param_time:
+    s_div = si_roundf(valf * (dsp::TempoClock::k_div_count - 1));
+    break;
+  case k_user_delfx_param_depth:
+    s_depth = valf;
+    break;
+  case k_user_delfx_param_shift_depth:
+    s_mix = valf;
+    break;
+  default:
+    break;
+  }
+}
@@ -41,6 +41,7 @@
 
 #include "userosc.h"
 #include "biquad.hpp"
+#include "noise.hpp"
 
 struct Waves {
 
@@ -81,27 +82,29 @@ struct Waves {
     const float   *wave0;
     const float   *wave1;
     const float   *subwave;
-          float    phi0;
-          float    phi1;
-          float    phisub;
-          float    w00;
-          float    w01;
-          float    w0sub;
+          uint32_t phi0;
+          uint32_t phi1;
+          uint32_t phisub;
+          uint32_t w00;
+          uint32_t w01;
+          uint32_t w0sub;
           float    lfo;
           float    lfoz;
           float    dither;
           float    bitres;
           float    bitresrcp;
           float    imperfection;
+          osc_pitch_t pitch;
+          dsp::Noise  noise;
           uint32_t flags:8;
     
     State(void) :
       wave0(wavesA[0]),
       wave1(wavesD[0]),
       subwave(wavesA[0]),
-      w00(440.f * k_samplerate_recipf),
-      w01(440.f * k_samplerate_recipf),
-      w0sub(220.f * k_samplerate_recipf),
+      w00((uint32_t)(440.f * k_samplerate_recipf * 4294967296.f)),
+      w01((uint32_t)(440.f * k_samplerate_recipf * 4294967296.f)),
+      w0sub((uint32_t)(220.f * k_samplerate_recipf * 4294967296.f)),
       lfo(0.f),
       lfoz(0.f),
       dither(0.f),
@@ -111,6 +114,8 @@ struct Waves {
     {
       reset();
       imperfection = osc_white() * 1.0417e-006f; // +/- 0.05Hz@48KHz
+      osc_pitch_reset(&pitch);
+      noise.seed(osc_rand());
     }
     
     inline void reset(void)
@@ -136,61 +141,21 @@ struct Waves {
   inline void updatePitch(float w0) {
     w0 += state.imperfection;
     const float drift = params.shiftshape;
-    state.w00 = w0;
+    // Phase increments scaled to 2^32 for integer phase scanning
+    state.w00 = (uint32_t)(w0 * 4294967296.f);
     // Alt osc with slight drift (0.25Hz@48KHz)
-    state.w01 = w0 + drift * 5.20833333333333e-006f;
+    state.w01 = (uint32_t)((w0 + drift * 5.20833333333333e-006f) * 4294967296.f);
     // Sub one octave and a phase drift (0.15Hz@48KHz)
-    state.w0sub = 0.5f * w0 + drift * 3.125e-006f;
+    state.w0sub = (uint32_t)((0.5f * w0 + drift * 3.125e-006f) * 4294967296.f);
   }
     
   inline void updateWaves(const uint16_t flags) {
-    if (flags & k_flag_wave0) {
-      static const uint8_t k_a_thr = k_waves_a_cnt;
-      static const uint8_t k_b_thr = k_a_thr + k_waves_b_cnt;
-      static const uint8_t k_c_thr = k_b_thr + k_waves_c_cnt;
-      
-      uint8_t idx = params.wave0;
-      const float * const * table;
-      
-      if (idx < k_a_thr) {
-        table = wavesA;
-      }
-      else if (idx < k_b_thr) {
-        table = wavesB;
-        idx -= k_a_thr;
-      }
-      else { 
-        table = wavesC;
-        idx -= k_b_thr;
-      }
-      state.wave0 = table[idx];
-    }
-    if (flags & k_flag_wave1) {
-      static const uint8_t k_d_thr = k_waves_d_cnt;
-      static const uint8_t k_e_thr = k_d_thr + k_waves_e_cnt;
-      static const uint8_t k_f_thr = k_e_thr + k_waves_f_cnt;
-      
-      uint8_t idx = params.wave1;
-      const float * const * table;
-      
-      if (idx < k_d_thr) {
-        table = wavesD;
-      }
-      else if (idx < k_e_thr) {
-        table = wavesE;
-        idx -= k_d_thr;
-      }
-      else { // if (idx < k_f_thr) {
-        table = wavesF;
-        idx -= k_e_thr;
-      }
-      
-      state.wave1 = table[idx];
-    }
-    if (flags & k_flag_subwave) {
-      const uint8_t idx = params.subwave;
-      state.subwave = wavesA[params.subwave];
-    }
+    if (flags & k_flag_wave0)
+      state.wave0 = osc_wave_get(k_waves_a_ofs + params.wave0);
+    if (flags & k_flag_wave1)
+      state.wave1 = osc_wave_get(k_waves_d_ofs + params.wave1);
+    if (flags & k_flag_subwave)
+      state.subwave = osc_wave_get(k_waves_a_ofs + params.subwave);
   }
 
   State       state;
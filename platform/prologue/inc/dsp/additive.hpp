@@ -0,0 +1,270 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+
+#include "float_math.h"
+
+/**
+ * @file    additive.hpp
+ * @brief   Recurrence based additive oscillator bank.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ */
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Bank of N harmonic sine partials, advanced by complex rotation rather than table lookups.
+   *
+   * Each partial is a phasor (re, im) multiplied by its per sample rotation (c, s) every sample, the output being the
+   * sum of the imaginary parts weighted by the partial amplitudes. Rotations are derived from the fundamental on pitch
+   * changes, partial k rotating by the (k+1)-th power of the fundamental's, which is the complex form of the Chebyshev
+   * recurrence. Phasor magnitudes are renormalized once per block to cancel rounding drift.
+   *
+   * Partial amplitudes are ramped linearly across each block towards their targets. Partials at or above Nyquist for
+   * the current pitch are culled: zeroed and skipped, as are trailing silent partials.
+   *
+   * State is kept as structure of arrays, with partials in the inner loop so that the host compiler can vectorize it.
+   *
+   * @tparam N Number of partials.
+   */
+  template<uint8_t N>
+  struct Additive {
+
+    /*===========================================================================*/
+    /* Types and Data Structures.                                                */
+    /*===========================================================================*/
+
+    enum {
+      k_partials = N
+    };
+
+    /*===========================================================================*/
+    /* Constructor / Destructor.                                                 */
+    /*===========================================================================*/
+
+    /**
+     * Default constructor
+     */
+    Additive(void) :
+      mW0(0.f), mLimit(0), mActive(0)
+    {
+      for (uint32_t k = 0; k < N; ++k) {
+        mC[k] = 1.f;
+        mS[k] = 0.f;
+        mAmp[k] = mTarget[k] = 0.f;
+      }
+      reset();
+    }
+    
+    /*===========================================================================*/
+    /* Public Methods.                                                           */
+    /*===========================================================================*/
+
+    /**
+     * Reset all partials to zero phase.
+     */
+    inline __attribute__((optimize("Ofast")))
+    void reset(void)
+    {
+      for (uint32_t k = 0; k < N; ++k) {
+        mRe[k] = 1.f;
+        mIm[k] = 0.f;
+      }
+    }
+
+    /**
+     * Set target amplitude of a partial, reached at the end of the next block.
+     *
+     * @param k   Partial index, 0 for the fundamental.
+     * @param amp Amplitude.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setAmplitude(const uint32_t k, const float amp)
+    {
+      mTarget[k] = amp;
+    }
+
+    /**
+     * Set target amplitudes of all partials.
+     *
+     * @param amp Array of N amplitudes.
+     */
+    inline __attribute__((optimize("Ofast")))
+    void setAmplitudes(const float * __restrict amp)
+    {
+      for (uint32_t k = 0; k < N; ++k)
+        mTarget[k] = amp[k];
+    }
+
+    /**
+     * Set fundamental phase increment. Rotations are only recomputed on change.
+     *
+     * @param w0 Phase increment in [0, 0.5), e.g.: from osc_w0f_for_pitch().
+     */
+    inline __attribute__((optimize("Ofast")))
+    void setPitch(const float w0)
+    {
+      if (w0 == mW0)
+        return;
+      mW0 = w0;
+
+      // Partials k with (k+1) * w0 < 0.5
+      const float h = (w0 > 0.f) ? 0.5f / w0 : (float)N + 1.f;
+      uint32_t limit = (h > N) ? N : (uint32_t)h;
+      if (limit && (float)limit == h)
+        --limit;
+      mLimit = limit;
+      
+      float c1, s1;
+      rotation(w0, c1, s1);
+      float c = c1, s = s1;
+      for (uint32_t k = 0; k < limit; ++k) {
+        mC[k] = c;
+        mS[k] = s;
+        const float t = c * c1 - s * s1;
+        s = c * s1 + s * c1;
+        c = t;
+      }
+    }
+
+    /**
+     * Render a block of samples, overwriting output.
+     *
+     * @param out Output buffer.
+     * @param n   Number of samples to render.
+     */
+    inline __attribute__((optimize("Ofast")))
+    void render(float * __restrict out, const uint32_t n)
+    {
+      float * __restrict re = mRe;
+      float * __restrict im = mIm;
+      float * __restrict amp = mAmp;
+      const float * __restrict c = mC;
+      const float * __restrict s = mS;
+      float damp[N];
+
+      const float nrecip = 1.f / n;
+      const uint32_t limit = mLimit;
+      uint32_t active = 0;
+      for (uint32_t k = 0; k < limit; ++k) {
+        damp[k] = (mTarget[k] - amp[k]) * nrecip;
+        if (mTarget[k] != 0.f || amp[k] != 0.f)
+          active = k + 1;
+      }
+      for (uint32_t k = limit; k < N; ++k)
+        amp[k] = 0.f;
+      mActive = active;
+      
+      for (uint32_t i = 0; i < n; ++i) {
+        float y = 0.f;
+        for (uint32_t k = 0; k < active; ++k) {
+          y += amp[k] * im[k];
+          const float r = re[k] * c[k] - im[k] * s[k];
+          im[k] = re[k] * s[k] + im[k] * c[k];
+          re[k] = r;
+          amp[k] += damp[k];
+        }
+        out[i] = y;
+      }
+      
+      for (uint32_t k = 0; k < active; ++k) {
+        // First order Newton step towards unit magnitude
+        const float g = 1.5f - 0.5f * (re[k] * re[k] + im[k] * im[k]);
+        re[k] *= g;
+        im[k] *= g;
+        amp[k] = mTarget[k];
+      }
+    }
+
+    /**
+     * Number of partials below Nyquist for the current pitch.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    uint32_t limit(void) const
+    {
+      return mLimit;
+    }
+
+    /**
+     * Number of partials rendered in the last block.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    uint32_t active(void) const
+    {
+      return mActive;
+    }
+
+    /*===========================================================================*/
+    /* Private Methods.                                                          */
+    /*===========================================================================*/
+
+    /**
+     * Per sample rotation for phase increment w in [0, 0.5].
+     *
+     * Computed from the half angle, in [0, pi/2], so that short series stay accurate, the frequency error being that of
+     * the sine for small angles.
+     */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    void rotation(const float w, float &c, float &s)
+    {
+      const float x = (float)M_PI * w;
+      const float x2 = x * x;
+      const float sh = x * (1.f - x2 * (1.f/6.f - x2 * (1.f/120.f - x2 * (1.f/5040.f - x2 * (1.f/362880.f)))));
+      const float ch = 1.f - x2 * (0.5f - x2 * (1.f/24.f - x2 * (1.f/720.f - x2 * (1.f/40320.f - x2 * (1.f/3628800.f)))));
+      s = 2.f * sh * ch;
+      c = 1.f - 2.f * sh * sh;
+    }
+    
+    /*===========================================================================*/
+    /* Members Vars                                                              */
+    /*===========================================================================*/
+
+    float    mRe[N];     // phasors, real part
+    float    mIm[N];     // phasors, imaginary part
+    float    mC[N];      // per sample rotations, real part
+    float    mS[N];      // per sample rotations, imaginary part
+    float    mAmp[N];    // current amplitudes
+    float    mTarget[N]; // target amplitudes
+    float    mW0;        // fundamental phase increment
+    uint32_t mLimit;     // partials below Nyquist
+    uint32_t mActive;    // partials rendered in last block
+  };
+}
+
+/** @} */
@@ -0,0 +1,368 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+
+#include "fixed_math.h"
+#include "float_math.h"
+
+/**
+ * @file    dxenvelope.hpp
+ * @brief   DX7 style operator envelope.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ */
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Four stage DX7 style envelope, after the one found in Dexed / Music Synthesizer for Android.
+   *
+   * Stages are attack, decay 1, decay 2 and release, each with a rate and a target level in [0, 99]. The decay 2
+   * level is held as sustain level until key up.
+   *
+   * The envelope is meant to be processed once per block: process() returns the level in log2 domain, Q24.
+   * gainRamp() converts it to a linear gain, Q24, via a lookup table, and provides the per sample increment to reach
+   * it over the block.
+   */
+  struct DxEnvelope {
+
+    /*===========================================================================*/
+    /* Types and Data Structures.                                                */
+    /*===========================================================================*/
+
+    enum {
+      k_stage_attack = 0,
+      k_stage_decay1,
+      k_stage_decay2,
+      k_stage_release,
+      k_stage_idle,
+      k_stage_count = 4
+    };
+    
+    /*===========================================================================*/
+    /* Constructor / Destructor.                                                 */
+    /*===========================================================================*/
+
+    /**
+     * Default constructor
+     */
+    DxEnvelope(void) :
+      level(0), target(0), outlevel(0), inc(0), staticcount(0), ix(k_stage_idle), rising(false), down(false),
+      gain(0), sr_multiplier(1 << 24)
+    {
+      for (uint32_t i = 0; i < k_stage_count; ++i) {
+        rates[i] = 99;
+        levels[i] = 0;
+      }
+    }
+    
+    /*===========================================================================*/
+    /* Public Methods.                                                           */
+    /*===========================================================================*/
+
+    /**
+     * Set sample rate, rates are calibrated for 44.1kHz.
+     *
+     * @param samplerate Sample rate in Hz.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setSampleRate(const uint32_t samplerate)
+    {
+      sr_multiplier = (uint32_t)(((uint64_t)44100 << 24) / samplerate);
+    }
+
+    /**
+     * Restart envelope at attack stage, e.g.: on note on.
+     *
+     * @param r  Stage rates in [0, 99].
+     * @param l  Stage levels in [0, 99].
+     * @param ol Output level, as returned by outputLevel().
+     */
+    inline __attribute__((optimize("Ofast")))
+    void init(const uint8_t r[k_stage_count], const uint8_t l[k_stage_count], const int32_t ol)
+    {
+      set(r, l, ol);
+      level = 0;
+      down = true;
+      advance(k_stage_attack);
+    }
+
+    /**
+     * Update rates, levels and output level while running.
+     *
+     * While the key is down, the envelope restarts towards the sustain level.
+     *
+     * @param r  Stage rates in [0, 99].
+     * @param l  Stage levels in [0, 99].
+     * @param ol Output level, as returned by outputLevel().
+     */
+    inline __attribute__((optimize("Ofast")))
+    void update(const uint8_t r[k_stage_count], const uint8_t l[k_stage_count], const int32_t ol)
+    {
+      set(r, l, ol);
+      if (down) {
+        int32_t actual = ((scaleLevel(levels[k_stage_decay2]) >> 1) << 6) - 4256;
+        actual = (actual < 16) ? 16 : actual;
+        target = actual << 16;
+        advance(k_stage_decay2);
+      }
+    }
+
+    /**
+     * Set key state, key up enters release stage.
+     *
+     * @param d True for key down.
+     */
+    inline __attribute__((optimize("Ofast")))
+    void keydown(const bool d)
+    {
+      if (down != d) {
+        down = d;
+        advance(d ? k_stage_attack : k_stage_release);
+      }
+    }
+
+    /**
+     * Advance envelope by one block.
+     *
+     * @param  frames Block size, rates are calibrated for 64 samples.
+     * @return        Level at end of block, log2 in Q24.
+     */
+    inline __attribute__((optimize("Ofast")))
+    int32_t process(const uint32_t frames)
+    {
+      if (staticcount) {
+        staticcount -= frames;
+        if (staticcount <= 0) {
+          staticcount = 0;
+          advance(ix + 1);
+        }
+      }
+      
+      if (ix < k_stage_release || (ix < k_stage_idle && !down)) {
+        if (rising) {
+          const int32_t jumptarget = 1716 << 16;
+          if (level < jumptarget)
+            level = jumptarget;
+          level += (((17 << 24) - level) >> 24) * inc;
+          if (level >= target) {
+            level = target;
+            advance(ix + 1);
+          }
+        }
+        else if (!staticcount) {
+          level -= inc;
+          if (level <= target) {
+            level = target;
+            advance(ix + 1);
+          }
+        }
+      }
+      return level;
+    }
+
+    /**
+     * Advance envelope by one block and compute linear gain ramp over it.
+     *
+     * @param frames Block size.
+     * @param g      Gain at start of block, Q24.
+     * @param dg     Per sample gain increment, Q24.
+     */
+    inline __attribute__((optimize("Ofast")))
+    void gainRamp(const uint32_t frames, int32_t &g, int32_t &dg)
+    {
+      g = gain;
+      gain = levelToGain(process(frames));
+      dg = (gain - g + (int32_t)(frames >> 1)) / (int32_t)frames;
+    }
+
+    /**
+     * Current level, log2 in Q24.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    int32_t getLevel(void) const
+    {
+      return level;
+    }
+
+    /**
+     * Level targeted by current stage, log2 in Q24.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    int32_t getTarget(void) const
+    {
+      return target;
+    }
+
+    /**
+     * Linear gain at end of last block processed by gainRamp(), Q24.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    int32_t getGain(void) const
+    {
+      return gain;
+    }
+
+    /**
+     * Convert level to linear gain, 2^(level - 14), via a 64 point table.
+     *
+     * @param  l Level, log2 in Q24.
+     * @return   Linear gain, Q24.
+     */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    int32_t levelToGain(const int32_t l)
+    {
+      static const float pow2_lut[65] = {
+        1.000000000f, 1.010889286f, 1.021897149f, 1.033024879f, 1.044273782f, 1.055645178f, 1.067140401f, 1.078760798f,
+        1.090507733f, 1.102382583f, 1.114386743f, 1.126521619f, 1.138788635f, 1.151189230f, 1.163724859f, 1.176396992f,
+        1.189207115f, 1.202156731f, 1.215247360f, 1.228480536f, 1.241857812f, 1.255380757f, 1.269050957f, 1.282870016f,
+        1.296839555f, 1.310961212f, 1.325236643f, 1.339667524f, 1.354255547f, 1.369002423f, 1.383909882f, 1.398979673f,
+        1.414213562f, 1.429613338f, 1.445180807f, 1.460917794f, 1.476826146f, 1.492907728f, 1.509164428f, 1.525598151f,
+        1.542210825f, 1.559004400f, 1.575980845f, 1.593142151f, 1.610490332f, 1.628027422f, 1.645755478f, 1.663676580f,
+        1.681792831f, 1.700106354f, 1.718619298f, 1.737333835f, 1.756252160f, 1.775376493f, 1.794709075f, 1.814252176f,
+        1.834008086f, 1.853979125f, 1.874167634f, 1.894575982f, 1.915206561f, 1.936061793f, 1.957144124f, 1.978456026f,
+        2.000000000f
+      };
+      if (l <= 0)
+        return 1 << 10;
+      const uint32_t i = ((uint32_t)l >> 24 < 19) ? (uint32_t)l >> 24 : 19;
+      const float fr = (float)(l & 0x3FFFF) * (1.f / (1 << 18));
+      const uint32_t idx = (l >> 18) & 0x3F;
+      return (int32_t)(linintf(fr, pow2_lut[idx], pow2_lut[idx+1]) * (float)(1U << (i + 10)));
+    }
+
+    /**
+     * Scale level in [0, 99] to the internal [0, 127] range.
+     */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    int32_t scaleLevel(const int32_t l)
+    {
+      static const uint8_t levellut[20] = {
+        0, 5, 9, 13, 17, 20, 23, 25, 27, 29, 31, 33, 35, 37, 39, 41, 42, 43, 45, 46
+      };
+      return (l >= 20) ? 28 + l : levellut[(l < 0) ? 0 : l];
+    }
+
+    /**
+     * Output level argument to init() and update() for given level in [0, 99].
+     */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    int32_t outputLevel(const int32_t l)
+    {
+      const int32_t s = scaleLevel(l);
+      return ((s > 127) ? 127 : s) << 5;
+    }
+
+    /*===========================================================================*/
+    /* Private Methods.                                                          */
+    /*===========================================================================*/
+
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void set(const uint8_t r[k_stage_count], const uint8_t l[k_stage_count], const int32_t ol)
+    {
+      for (uint32_t i = 0; i < k_stage_count; ++i) {
+        rates[i] = r[i];
+        levels[i] = l[i];
+      }
+      outlevel = ol;
+    }
+
+    /**
+     * Approximate number of samples at 44.1kHz spent at rate r in [0, 76] when level does not change.
+     */
+    static inline __attribute__((optimize("Ofast"),always_inline))
+    int32_t staticSamples(const uint8_t r)
+    {
+      static const int32_t statics[77] = {
+        1764000, 1764000, 1411200, 1411200, 1190700, 1014300, 992250,
+        882000, 705600, 705600, 584325, 507150, 502740, 441000, 418950,
+        352800, 308700, 286650, 253575, 220500, 220500, 176400, 145530,
+        145530, 125685, 110250, 110250, 88200, 88200, 74970, 61740,
+        61740, 55125, 48510, 44100, 37485, 31311, 30870, 27562, 27562,
+        22050, 18522, 17640, 15435, 14112, 13230, 11025, 9261, 9261, 7717,
+        6615, 6615, 5512, 5512, 4410, 3969, 3969, 3439, 2866, 2690, 2249,
+        1984, 1896, 1808, 1411, 1367, 1234, 1146, 926, 837, 837, 705,
+        573, 573, 529, 441, 441
+      };
+      return (r < 77) ? statics[r] : 20 * (99 - r);
+    }
+
+    inline __attribute__((optimize("Ofast")))
+    void advance(const int32_t newix)
+    {
+      ix = newix;
+      if (ix >= k_stage_idle)
+        return;
+
+      int32_t actual = ((scaleLevel(levels[ix]) >> 1) << 6) + outlevel - 4256;
+      actual = (actual < 16) ? 16 : actual;
+      target = actual << 16;
+      rising = (target > level);
+
+      // Rate in [0, 99] to [0, 63]
+      const int32_t qrate = (rates[ix] * 41) >> 6;
+      
+      if (target == level)
+        staticcount = (int32_t)(((int64_t)staticSamples(rates[ix]) * sr_multiplier) >> 24);
+      else
+        staticcount = 0;
+      
+      inc = (4 + (qrate & 3)) << (8 + (qrate >> 2));
+      inc = (int32_t)(((int64_t)inc * sr_multiplier) >> 24);
+    }
+    
+    /*===========================================================================*/
+    /* Members Vars                                                              */
+    /*===========================================================================*/
+
+    int32_t  level;       // log2, Q24
+    int32_t  target;      // log2, Q24
+    int32_t  outlevel;
+    int32_t  inc;
+    int32_t  staticcount;
+    int32_t  ix;
+    bool     rising;
+    bool     down;
+    int32_t  gain;        // linear gain at end of last block, Q24
+    uint32_t sr_multiplier;
+    uint8_t  rates[k_stage_count];
+    uint8_t  levels[k_stage_count];
+  };
+}
+
+/** @} */
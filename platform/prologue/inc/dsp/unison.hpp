@@ -0,0 +1,314 @@
+#pragma once
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+
+#include "fixed_math.h"
+#include "float_math.h"
+#include "buffer_ops.h"
+
+/**
+ * @file    unison.hpp
+ * @brief   Unison oscillator stack.
+ *
+ * @addtogroup dsp DSP
+ * @{
+ */
+
+/**
+ * Common DSP Utilities
+ */
+namespace dsp {
+
+  /**
+   * Stack of up to N detuned sub-voices, e.g.: for supersaw style sounds.
+   *
+   * Sub-voice phases, increments and gains are stored as arrays and blocks are rendered one sub-voice at a
+   * time, so that the state of the sub-voice being rendered stays in registers. The waveform is provided by a
+   * kernel, any type providing:
+   *
+   *   float operator()(const uint32_t phi, const uint32_t w, const float rw) const
+   *
+   * where phi is the phase, w the phase increment and rw its reciprocal. For instance PolyBLEPOsc::Kernel, or a
+   * small wrapper around osc_wave_scanuf() or osc_bl_sawuf().
+   *
+   * @tparam N Maximum number of sub-voices.
+   */
+  template<uint32_t N>
+  struct Unison {
+
+    /*===========================================================================*/
+    /* Types and Data Structures.                                                */
+    /*===========================================================================*/
+
+    enum {
+      k_max_voices = N
+    };
+    
+    /*===========================================================================*/
+    /* Constructor / Destructor.                                                 */
+    /*===========================================================================*/
+
+    /**
+     * Default constructor
+     */
+    Unison(void) :
+      mW0(0), mDetune(0.f), mSpread(0.f), mVoices(N)
+    {
+      reset(0);
+      update();
+    }
+    
+    /*===========================================================================*/
+    /* Public Methods.                                                           */
+    /*===========================================================================*/
+
+    /**
+     * Reset sub-voice phases, spread pseudo-randomly from given seed, e.g.: osc_rand().
+     *
+     * @param seed Seed for phase distribution, 0 to align all phases.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void reset(uint32_t seed)
+    {
+      for (uint32_t i = 0; i < N; ++i) {
+        phi[i] = seed;
+        if (seed)
+          seed = seed * 1664525U + 1013904223U;
+      }
+    }
+
+    /**
+     * Set center phase increment, e.g.: as returned by osc_w0u_for_note().
+     *
+     * @param w Phase increment, full cycle over 2^32
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setW0(const uint32_t w)
+    {
+      if (w != mW0) {
+        mW0 = w;
+        updateIncrements();
+      }
+    }
+
+    /**
+     * Set detune amount.
+     *
+     * @param detune Detune in [0, 1], 1 for +/- 5% (about 85 cents) on outermost sub-voices.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setDetune(const float detune)
+    {
+      mDetune = clip01f(detune);
+      updateIncrements();
+    }
+
+    /**
+     * Set stereo spread of sub-voices.
+     *
+     * @param spread Spread in [0, 1], 0 for mono.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setSpread(const float spread)
+    {
+      mSpread = clip01f(spread);
+      updateGains();
+    }
+
+    /**
+     * Set number of active sub-voices.
+     *
+     * @param voices Number of sub-voices, clipped to [1, N].
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setVoices(const uint32_t voices)
+    {
+      const uint32_t v = (voices < 1) ? 1 : (voices > N) ? N : voices;
+      if (v != mVoices) {
+        mVoices = v;
+        update();
+      }
+    }
+
+    /**
+     * Cap number of active sub-voices to a CPU budget.
+     *
+     * @param budget     Cycles per sample available to the stack.
+     * @param voice_cost Cycles per sample of a single sub-voice, for the kernel in use.
+     * @param voices     Number of sub-voices wanted, actual count is the lowest of voices, N and what fits in the budget.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    void setVoiceBudget(const uint32_t budget, const uint32_t voice_cost, const uint32_t voices = N)
+    {
+      const uint32_t fit = voice_cost ? budget / voice_cost : N;
+      setVoices((fit < voices) ? fit : voices);
+    }
+
+    /**
+     * Get number of active sub-voices.
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    uint32_t voices(void) const
+    {
+      return mVoices;
+    }
+
+    /**
+     * Recompute increments and gains of active sub-voices.
+     */
+    inline __attribute__((optimize("Ofast")))
+    void update(void)
+    {
+      updateIncrements();
+      updateGains();
+    }
+
+    /**
+     * Render a block of mono samples, overwriting output.
+     *
+     * @param kernel Waveform kernel.
+     * @param out    Output buffer.
+     * @param n      Number of samples to render.
+     */
+    template<typename K>
+    inline __attribute__((optimize("Ofast")))
+    void render(const K &kernel, float * __restrict out, const uint32_t n)
+    {
+      buf_clr_f32(out, n);
+      for (uint32_t v = 0; v < mVoices; ++v) {
+        uint32_t p = phi[v];
+        const uint32_t w = w0[v];
+        const float r = rw[v];
+        const float g = gain[v];
+        for (uint32_t i = 0; i < n; ++i, p += w)
+          out[i] += g * kernel(p, w, r);
+        phi[v] = p;
+      }
+    }
+
+    /**
+     * Render a block of stereo samples, overwriting output.
+     *
+     * @param kernel Waveform kernel.
+     * @param out    Output buffer, interleaved left/right.
+     * @param n      Number of frames to render.
+     */
+    template<typename K>
+    inline __attribute__((optimize("Ofast")))
+    void renderStereo(const K &kernel, float * __restrict out, const uint32_t n)
+    {
+      buf_clr_f32(out, 2 * n);
+      for (uint32_t v = 0; v < mVoices; ++v) {
+        uint32_t p = phi[v];
+        const uint32_t w = w0[v];
+        const float r = rw[v];
+        const float gl = gainL[v];
+        const float gr = gainR[v];
+        float * __restrict o = out;
+        for (uint32_t i = 0; i < n; ++i, p += w, o += 2) {
+          const float y = kernel(p, w, r);
+          o[0] += gl * y;
+          o[1] += gr * y;
+        }
+        phi[v] = p;
+      }
+    }
+
+    /*===========================================================================*/
+    /* Private Methods.                                                          */
+    /*===========================================================================*/
+
+    /**
+     * Relative position of sub-voice in the stack, in [-1, 1].
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    float position(const uint32_t v) const
+    {
+      return (mVoices > 1) ? 2.f * v / (float)(mVoices - 1) - 1.f : 0.f;
+    }
+
+    /**
+     * Sub-voice index visited at given step when going through the stack from the outside in: 0, M-1, 1, M-2, ...
+     */
+    inline __attribute__((optimize("Ofast"),always_inline))
+    uint32_t order(const uint32_t v) const
+    {
+      return (v & 1) ? mVoices - 1 - (v >> 1) : (v >> 1);
+    }
+    
+    inline __attribute__((optimize("Ofast")))
+    void updateIncrements(void)
+    {
+      const float w = (float)mW0;
+      const float d = mDetune * 0.05f;
+      for (uint32_t v = 0; v < mVoices; ++v) {
+        const float wv = w * (1.f + d * position(v));
+        w0[v] = (uint32_t)wv;
+        rw[v] = (w0[v]) ? 1.f / wv : 0.f;
+      }
+    }
+    
+    inline __attribute__((optimize("Ofast")))
+    void updateGains(void)
+    {
+      // Keep overall level roughly constant for uncorrelated sub-voices
+      const float g = fastpowf((float)mVoices, -0.5f);
+      for (uint32_t v = 0; v < mVoices; ++v) {
+        // Pan as per outside-in order so that neighbouring detunes end up apart and pans cancel out
+        const float pan = mSpread * position(order(v));
+        gain[v] = g;
+        gainL[v] = g * (1.f - pan);
+        gainR[v] = g * (1.f + pan);
+      }
+    }
+    
+    /*===========================================================================*/
+    /* Members Vars                                                              */
+    /*===========================================================================*/
+
+    uint32_t phi[N];
+    uint32_t w0[N];
+    float    rw[N];
+    float    gain[N];
+    float    gainL[N];
+    float    gainR[N];
+    
+    uint32_t mW0;
+    float    mDetune;
+    float    mSpread;
+    uint32_t mVoices;
+  };
+}
+
+/** @} */
@@ -149,14 +149,21 @@ extern "C" {
   }
   
   /**
-   * Lookup value of sin(2*pi*x) in [0, 1.0] range.
+   * Lookup value of sin(2*pi*x) for integer phase.
    *
-   * @param   x  Phase ratio.
+   * @param   x  Phase, full cycle over 2^32.
    * @return     Result of sin(2*pi*x).
    */
   __fast_inline float fx_sinuf(uint32_t x) {
-    (void)x;
-    return 0.f;
+    // half period stored -- wrap around and invert
+    const uint32_t x0p = x >> k_wt_sine_u32shift;
+
+    const uint32_t x0 = x0p & k_wt_sine_mask;
+    const uint32_t x1 = (x0 + 1) & k_wt_sine_mask;
+    const float fr = k_wt_sine_frrecip * (float)(x & ((1U<<k_wt_sine_u32shift)-1));
+    
+    const float y0 = linintf(fr, wt_sine_lut_f[x0], wt_sine_lut_f[x1]);
+    return (x0p < k_wt_sine_size)?y0:-y0;
   }
   
   /**
@@ -170,13 +177,43 @@ extern "C" {
   }
 
   /**
-   * Lookup value of cos(2*pi*x) in [0, 1.0] range.
+   * Lookup value of cos(2*pi*x) for integer phase.
    *
-   * @param   x  Phase ratio.
-   * @return     Result of sin(2*pi*x).
+   * @param   x  Phase, full cycle over 2^32.
+   * @return     Result of cos(2*pi*x).
    */
   __fast_inline float fx_cosuf(uint32_t x) {
-    return fx_sinuf(x+((k_wt_sine_size>>2)<<k_wt_sine_u32shift));
+    // quarter period is half of the stored half-wave
+    return fx_sinuf(x+((k_wt_sine_size>>1)<<k_wt_sine_u32shift));
+  }
+
+  /**
+   * Fill buffer with sin(2*pi*x) for an integer phase ramp.
+   *
+   * @param   out     Output buffer.
+   * @param   frames  Number of samples to render.
+   * @param   x       Phase of first sample, full cycle over 2^32.
+   * @param   w       Phase increment per sample, full cycle over 2^32.
+   * @return          Phase following the last rendered sample.
+   */
+  __fast_inline uint32_t fx_sinuf_buf(float * __restrict__ out, uint32_t frames, uint32_t x, uint32_t w) {
+    const float * out_e = out + frames;
+    for (; out != out_e; x += w)
+      *(out++) = fx_sinuf(x);
+    return x;
+  }
+
+  /**
+   * Fill buffer with cos(2*pi*x) for an integer phase ramp.
+   *
+   * @param   out     Output buffer.
+   * @param   frames  Number of samples to render.
+   * @param   x       Phase of first sample, full cycle over 2^32.
+   * @param   w       Phase increment per sample, full cycle over 2^32.
+   * @return          Phase following the last rendered sample.
+   */
+  __fast_inline uint32_t fx_cosuf_buf(float * __restrict__ out, uint32_t frames, uint32_t x, uint32_t w) {
+    return fx_sinuf_buf(out, frames, x+((k_wt_sine_size>>1)<<k_wt_sine_u32shift), w) - ((k_wt_sine_size>>1)<<k_wt_sine_u32shift);
   }
   
   /** @} */
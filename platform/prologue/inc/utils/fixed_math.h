@@ -142,6 +142,25 @@ typedef uint64_t uq64_0_t;
 #define f32_to_q15(f)   ((q15_t)ssat((q31_t)((float)(f) * ((1<<15)-1)),16))
 #define f32_to_q31(f)   ((q31_t)((float)(f) * (float)0x7FFFFFFF))
 
+/** Saturating float to Q31 conversion, out of range values are clamped to the Q31 extrema.
+ *  @note  A single VCVT with 31 fraction bits on ARM Cortex-M4, which saturates in hardware. Elsewhere the input is
+ *         clamped first, positive values then top out at 0x7FFFFF80.
+ */
+static inline __attribute__((optimize("Ofast"),always_inline))
+q31_t f32_to_q31_sat(float f) {
+#if defined(__ARM_FP)
+  q31_t q;
+  __asm__ ("vcvt.s32.f32 %1, %1, #31\n\t"
+           "vmov %0, %1" : "=r" (q), "+t" (f));
+  return q;
+#else
+  // Clamp to the largest float below 1, i.e.: 0x7FFFFF80, so that the conversion vectorizes
+  f = (f > -1.f) ? f : -1.f;
+  f = (f < 0.99999994f) ? f : 0.99999994f;
+  return (q31_t)(f * 2147483648.f);
+#endif
+}
+
 /** @} */
 
 /*===========================================================================*/
@@ -814,7 +814,6 @@ float fasterdbampf(const float db) {
 
 /**
  * @name    Interpolations
- * @todo    Add cubic/spline interpolations
  * @{
  */
 
@@ -833,6 +832,16 @@ float cosintf(const float fr, const float x0, const float x1) {
   return x0 + tmp * (x1 - x0);
 }
 
+/** Cubic Hermite (Catmull-Rom) interpolation between x0 and x1
+ */
+static inline __attribute__((optimize("Ofast"), always_inline))
+float hermintf(const float fr, const float xm1, const float x0, const float x1, const float x2) {
+  const float c1 = 0.5f * (x1 - xm1);
+  const float c2 = xm1 - 2.5f * x0 + 2.f * x1 - 0.5f * x2;
+  const float c3 = 0.5f * (x2 - xm1) + 1.5f * (x0 - x1);
+  return ((c3 * fr + c2) * fr + c1) * fr + x0;
+}
+
 /** @} */
 
 #endif // __float_math_h
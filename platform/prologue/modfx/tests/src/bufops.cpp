@@ -0,0 +1,116 @@
+/*
+ * File: bufops.cpp
+ *
+ * Runtime test and load bench for buffer operations, ring modulates the main timbre by the sub timbre with
+ * dry/wet mix, sub blend and level limiting
+ *
+ * Build with UDEFS = -DBENCH_REPEAT=<n> to run the processing chain n times per block, raising n until the unit
+ * overruns gives the relative cost of the chain on target.
+ * 
+ * 2018 (c) Korg
+ *
+ */
+
+#include "usermodfx.h"
+
+#include "buffer_ops.h"
+
+#ifndef BENCH_REPEAT
+#define BENCH_REPEAT 1
+#endif
+
+enum {
+  k_block_size = 64
+};
+
+static float s_mix_z, s_mix;
+static float s_sub_z, s_sub;
+static float s_gain_z;
+
+void MODFX_INIT(uint32_t platform, uint32_t api)
+{
+  s_mix_z = s_mix = 0.5f;
+  s_sub_z = s_sub = 0.f;
+  s_gain_z = 1.f;
+}
+
+void MODFX_PROCESS(const float *main_xn, float *main_yn,
+                   const float *sub_xn,  float *sub_yn,
+                   uint32_t frames)
+{
+  const float * mx = main_xn;
+  const float * sx = sub_xn;
+  float * __restrict my = main_yn;
+  const float * my_e = my + 2*frames;
+
+  // Mix and sub level ramp over the whole buffer
+  const float dmix = (s_mix - s_mix_z) / frames;
+  const float dsub = (s_sub - s_sub_z) / frames;
+  
+  float l[k_block_size], r[k_block_size];
+  float sl[k_block_size], sr[k_block_size];
+  float wl[k_block_size], wr[k_block_size];
+  
+  for (; my != my_e; ) {
+    const uint32_t remaining = (my_e - my) >> 1;
+    const uint32_t count = (remaining < k_block_size) ? remaining : k_block_size;
+
+    const float mix0 = s_mix_z;
+    const float mix1 = s_mix_z = mix0 + dmix * count;
+    const float sub = s_sub_z;
+    s_sub_z += dsub * count;
+    
+    for (uint32_t rep = 0; rep < BENCH_REPEAT; ++rep) {
+      buf_deinterleave_f32(mx, l, r, count);
+      buf_deinterleave_f32(sx, sl, sr, count);
+      
+      // Ring modulation, made up for the level lost in the product
+      buf_mul_f32(l, sl, wl, count);
+      buf_mul_f32(r, sr, wr, count);
+      buf_scale_f32(wl, wl, count, 2.f);
+      buf_scale_f32(wr, wr, count, 2.f);
+      
+      buf_xfade_f32(l, wl, l, count, mix0, mix1);
+      buf_xfade_f32(r, wr, r, count, mix0, mix1);
+
+      // Blend in the sub timbre
+      buf_mac_f32(sl, l, count, sub);
+      buf_mac_f32(sr, r, count, sub);
+
+      // Ramp towards a gain keeping the mid signal RMS under -6dB and the block peak under full scale
+      buf_add_f32(l, r, wl, count);
+      const float rms = 0.5f * buf_rms_f32(wl, count);
+      const float peak = clipminf(buf_peak_f32(l, count), buf_peak_f32(r, count));
+      float gain = (rms > 0.5f) ? 0.5f / rms : 1.f;
+      gain = (peak * gain > 1.f) ? 1.f / peak : gain;
+      buf_ramp_f32(l, l, count, s_gain_z, gain);
+      buf_ramp_f32(r, r, count, s_gain_z, gain);
+      if (rep == BENCH_REPEAT - 1)
+        s_gain_z = gain;
+      
+      buf_interleave_f32(l, r, my, count);
+    }
+    
+    mx += 2 * count;
+    sx += 2 * count;
+    my += 2 * count;
+  }
+
+  buf_cpy_f32(sub_xn, sub_yn, 2 * frames);
+}
+
+
+void MODFX_PARAM(uint8_t index, int32_t value)
+{
+  const float valf = q31_to_f32(value);
+  switch (index) {
+  case k_user_modfx_param_time:
+    s_mix = valf;
+    break;
+  case k_user_modfx_param_depth:
+    s_sub = valf;
+    break;
+  default:
+    break;
+  }
+}
@@ -0,0 +1,151 @@
+/*
+    BSD 3-Clause License
+
+    Copyright (c) 2018, KORG INC.
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this
+      list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived from
+      this software without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//*/
+
+/*
+ * File: wavebank.cpp
+ *
+ * Wave registry test, morphs across all waves ordered by brightness
+ *
+ */
+
+#include "userosc.h"
+
+enum {
+  k_block_size = 64
+};
+
+typedef struct State {
+  osc_wave_bank_t bank;
+  osc_pitch_t pitch;
+  uint32_t phi;
+  float pos;
+  float posz;
+  float limit;
+} State;
+
+static State s_state;
+
+void OSC_INIT(uint32_t platform, uint32_t api)
+{
+  osc_wave_bank_init(&s_state.bank);
+  osc_pitch_reset(&s_state.pitch);
+  s_state.phi = 0;
+  s_state.pos = 0.f;
+  s_state.posz = 0.f;
+  s_state.limit = 0.f;
+}
+
+void OSC_CYCLE(const user_osc_param_t * const params,
+               int32_t *yn,
+               const uint32_t frames)
+{
+  State &s = s_state;
+  osc_pitch_update(&s.pitch, params->pitch);
+
+  // Optionally cap brightness so that the wave centroid stays below a pitch independent frequency
+  float pos = s.pos;
+  if (s.limit > 0.f) {
+    const float maxpos = osc_wave_bank_find(&s.bank, s.limit / s.pitch.w0f);
+    pos = (pos < maxpos) ? pos : maxpos;
+  }
+  
+  uint32_t idx = (uint32_t)s.posz;
+  if (pos < s.posz && idx == s.posz && idx > 0)
+    --idx; // Moving down from a wave boundary
+  const uint32_t next = (idx + 1 < k_waves_cnt) ? idx + 1 : idx;
+  const float * wa = osc_wave_bank_get(&s.bank, idx);
+  const float * wb = osc_wave_bank_get(&s.bank, next);
+  const float mix0 = s.posz - idx;
+  // Stay between the same two waves for the whole buffer, the next buffer picks up from there
+  const float mix1 = clipminmaxf(0.f, pos - idx, 1.f);
+  
+  float buf[k_block_size];
+  
+  q31_t * __restrict y = (q31_t *)yn;
+  const q31_t * y_e = y + frames;
+  uint32_t phi = s.phi;
+  float mix = mix0;
+  const float dmix = (mix1 - mix0) / frames;
+  
+  for (; y != y_e; ) {
+    const uint32_t remaining = y_e - y;
+    const uint32_t count = (remaining < k_block_size) ? remaining : k_block_size;
+
+    phi = osc_wave_morph_scanuf_buf(buf, count, wa, wb, phi, s.pitch.w0u, mix, mix + dmix * count);
+    mix += dmix * count;
+    
+    const float *b = buf;
+    const q31_t *yc_e = y + count;
+    for (; y != yc_e; )
+      *(y++) = f32_to_q31(0.5f * *(b++));
+  }
+  
+  s.phi = phi;
+  s.posz = idx + mix1;
+}
+
+void OSC_NOTEON(const user_osc_param_t * const params)
+{
+  (void)params;
+  s_state.phi = 0;
+}
+
+void OSC_NOTEOFF(const user_osc_param_t * const params)
+{
+  (void)params;
+}
+
+void OSC_PARAM(uint16_t index, uint16_t value)
+{
+  const float valf = param_val_to_f32(value);
+  
+  switch (index) {
+  case k_user_osc_param_id1:
+  case k_user_osc_param_id2:
+  case k_user_osc_param_id3:
+  case k_user_osc_param_id4:
+  case k_user_osc_param_id5:
+  case k_user_osc_param_id6:
+    break;
+  case k_user_osc_param_shape:
+    // Position in brightness order, darkest to brightest
+    s_state.pos = valf * (k_waves_cnt - 1);
+    break;
+  case k_user_osc_param_shiftshape:
+    // Brightness cap, off at zero, else centroid limited to 12 kHz down to 480 Hz
+    s_state.limit = (value == 0) ? 0.f : (0.25f - valf * 0.24f);
+    break;
+  default:
+    break;
+  }
+}
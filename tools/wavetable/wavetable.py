@@ -0,0 +1,353 @@
+#!/usr/bin/env python3
+#
+#    BSD 3-Clause License
+#
+#    Copyright (c) 2018, KORG INC.
+#    All rights reserved.
+#
+#    Redistribution and use in source and binary forms, with or without
+#    modification, are permitted provided that the following conditions are met:
+#
+#    * Redistributions of source code must retain the above copyright notice, this
+#      list of conditions and the following disclaimer.
+#
+#    * Redistributions in binary form must reproduce the above copyright notice,
+#      this list of conditions and the following disclaimer in the documentation
+#      and/or other materials provided with the distribution.
+#
+#    * Neither the name of the copyright holder nor the names of its
+#      contributors may be used to endorse or promote products derived from
+#      this software without specific prior written permission.
+#
+#    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+#    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+#    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+#    DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+#    FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+#    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+#    SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+#    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+#    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+#    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+
+"""Convert single cycle waves to C tables for user oscillators.
+
+Waves are resampled to the wave bank layout of osc_api.h (k_waves_size points
+over a full cycle) and emitted as float arrays, or in one of the compressed
+formats decoded by the osc_wave_s8_* and osc_wave_s12_* functions.
+
+With --mipmaps, each wave is emitted as a set of band-limited tables, one per
+octave, along with a note to table index lookup, so that oscillators can pick
+an alias free table once per block.
+
+Inputs can be WAV files (PCM 8/16/24/32-bit or 32-bit float) holding a single
+cycle, or text files holding sample values, e.g.: an existing C array.
+"""
+
+import argparse
+import cmath
+import math
+import os
+import re
+import struct
+import sys
+
+WAVES_SIZE = 128
+SAMPLERATE = 48000
+NOTES_CNT = 152  # k_midi_to_hz_size
+
+FORMATS = {
+    # name: (bits, C type, bytes per wave)
+    'float': (0,  'float',          4 * (WAVES_SIZE + 1)),
+    's12':   (12, 'osc_wave_s12_t', 4 + 3 * WAVES_SIZE // 2),
+    's8':    (8,  'osc_wave_s8_t',  4 + WAVES_SIZE),
+}
+
+
+# -- Input -------------------------------------------------------------------
+
+def read_wav(path):
+    """Read first channel of a WAV file as floats in [-1, 1]."""
+    with open(path, 'rb') as f:
+        data = f.read()
+    if data[0:4] != b'RIFF' or data[8:12] != b'WAVE':
+        raise ValueError('%s: not a WAV file' % path)
+    pos = 12
+    fmt = None
+    while pos + 8 <= len(data):
+        cid, size = struct.unpack('<4sI', data[pos:pos+8])
+        body = data[pos+8:pos+8+size]
+        if cid == b'fmt ':
+            tag, channels, _, _, align, bits = struct.unpack('<HHIIHH', body[:16])
+            if tag == 0xFFFE:  # WAVE_FORMAT_EXTENSIBLE, actual tag in sub-format GUID
+                tag = struct.unpack('<H', body[24:26])[0]
+            fmt = (tag, channels, align, bits)
+        elif cid == b'data':
+            if fmt is None:
+                raise ValueError('%s: data before fmt chunk' % path)
+            tag, channels, align, bits = fmt
+            width = bits // 8
+            out = []
+            for i in range(0, len(body) - align + 1, align):
+                frame = body[i:i+width]
+                if tag == 3 and bits == 32:
+                    out.append(struct.unpack('<f', frame)[0])
+                elif tag == 1 and bits == 8:
+                    out.append((frame[0] - 128) / 128.0)
+                elif tag == 1 and bits in (16, 24, 32):
+                    v = int.from_bytes(frame, 'little', signed=True)
+                    out.append(v / float(1 << (bits - 1)))
+                else:
+                    raise ValueError('%s: unsupported sample format (tag %d, %d bits)' % (path, tag, bits))
+            return out
+        pos += 8 + size + (size & 1)
+    raise ValueError('%s: no data chunk' % path)
+
+
+def read_text(path):
+    """Read all numbers found in a text file, e.g.: a C array."""
+    with open(path) as f:
+        text = f.read()
+    text = re.sub(r'/\*.*?\*/|//[^\n]*', '', text, flags=re.S)
+    body = text[text.index('{')+1:text.rindex('}')] if '{' in text else text
+    nums = re.findall(r'[-+]?(?:\d+\.\d*|\.\d+|\d+)(?:[eE][-+]?\d+)?', body)
+    return [float(n) for n in nums]
+
+
+def read_wave(path):
+    if path.lower().endswith('.wav'):
+        return read_wav(path)
+    samples = read_text(path)
+    # Drop wrap around guard point of wave bank style tables
+    if len(samples) == WAVES_SIZE + 1 and samples[-1] == samples[0]:
+        samples = samples[:-1]
+    return samples
+
+
+# -- Processing --------------------------------------------------------------
+
+def dft(x, bins=None):
+    """Complex spectrum of a real signal, bins 0 to len(x)/2 or given count."""
+    n = len(x)
+    top = n // 2 if bins is None else min(bins, n // 2)
+    return [sum(x[k] * cmath.exp(-2j * math.pi * h * k / n) for k in range(n)) / n
+            for h in range(top + 1)]
+
+
+def synth(spectrum, n, harmonics=None):
+    """Sum of harmonics, evaluated at n points over a cycle."""
+    top = len(spectrum) - 1 if harmonics is None else min(harmonics, len(spectrum) - 1)
+    out = []
+    for k in range(n):
+        y = spectrum[0].real
+        for h in range(1, top + 1):
+            c = spectrum[h]
+            if 2 * h == n and c.imag == 0:
+                y += c.real * math.cos(math.pi * k)
+            else:
+                y += 2 * (c * cmath.exp(2j * math.pi * h * k / n)).real
+        out.append(y)
+    return out
+
+
+def resample(x, n=WAVES_SIZE):
+    """Resample one cycle to n points, keeping harmonics below n/2."""
+    if len(x) == n:
+        return list(x)
+    return synth(dft(x, n // 2), n, n // 2 - 1)
+
+
+def mip_harmonics(n=WAVES_SIZE):
+    """Highest harmonic of each mipmap level, one level per octave."""
+    levels = []
+    h = n // 2 - 1
+    while h >= 1:
+        levels.append(h)
+        h = (h + 1) // 2 if h > 1 else 0
+    return levels
+
+
+def mipmaps(x, n=WAVES_SIZE):
+    """Band-limited versions of one cycle, one per octave, with a common scale."""
+    spectrum = dft(x, n // 2)
+    return [synth(spectrum, n, h) for h in mip_harmonics(n)]
+
+
+def mip_notes(levels, samplerate=SAMPLERATE):
+    """Index of the richest alias free level for each note.
+
+    Notes can be raised by up to a semitone with the fractional part of the pitch, so levels are chosen for the
+    frequency of the following note.
+    """
+    out = []
+    for note in range(NOTES_CNT):
+        hz = 440.0 * 2 ** ((note + 1 - 69) / 12.0)
+        idx = 0
+        while idx < len(levels) - 1 and levels[idx] * hz > samplerate / 2:
+            idx += 1
+        out.append(idx)
+    return out
+
+
+def remove_dc(x):
+    dc = sum(x) / len(x)
+    return [v - dc for v in x]
+
+
+def normalize(x, peak=None):
+    """Scale to unit peak, or by 1/peak."""
+    peak = max(abs(v) for v in x) if peak is None else peak
+    return [v / peak for v in x] if peak > 0 else x
+
+
+def quantize(x, bits):
+    """Signed integer samples and scale factor."""
+    top = (1 << (bits - 1)) - 1
+    peak = max(abs(v) for v in x)
+    scale = peak / top if peak > 0 else 1.0
+    q = [max(-top - 1, min(top, int(round(v / scale)))) for v in x]
+    return q, scale
+
+
+def snr(x, y):
+    sig = sum(v * v for v in x)
+    err = sum((a - b) ** 2 for a, b in zip(x, y))
+    return float('inf') if err == 0 else 10 * math.log10(sig / err)
+
+
+def pack12(q):
+    out = []
+    for i in range(0, len(q), 2):
+        a, b = q[i] & 0xFFF, q[i+1] & 0xFFF
+        out += [a & 0xFF, (a >> 8) | ((b & 0x0F) << 4), b >> 4]
+    return out
+
+
+# -- Output ------------------------------------------------------------------
+
+def c_name(path):
+    name = re.sub(r'\W', '_', os.path.splitext(os.path.basename(path))[0])
+    return ('_' + name) if name[0].isdigit() else name
+
+
+def rows(values, fmt, per_row):
+    items = [fmt % v for v in values]
+    return ',\n'.join('  ' + ', '.join(items[i:i+per_row]) for i in range(0, len(items), per_row))
+
+
+def encode(x, fmt):
+    """C initializer of a wave, and SNR of its encoding."""
+    bits, _, _ = FORMATS[fmt]
+    if fmt == 'float':
+        return '{\n%s\n}' % rows(x + [x[0]], '%.9ef', 6), float('inf')
+    q, scale = quantize(x, bits)
+    quality = snr(x, [v * scale for v in q])
+    if fmt == 's8':
+        data = rows(q, '%4d', 16)
+    else:
+        data = rows(pack12(q), '0x%02x', 12)
+    return '{\n  %.9ef,\n  {\n%s\n  }\n}' % (scale, re.sub('(?m)^', '  ', data)), quality
+
+
+def emit_wave(name, x, fmt):
+    """C definition of a wave, and SNR of its encoding."""
+    _, ctype, _ = FORMATS[fmt]
+    init, quality = encode(x, fmt)
+    if fmt == 'float':
+        return 'const float %s[%d] = %s;\n' % (name, WAVES_SIZE + 1, init), quality
+    return 'const %s %s = %s;\n' % (ctype, name, init), quality
+
+
+def emit_mipmaps(name, levels, prefix, fmt):
+    """C definition of the mipmap levels of a wave, and worst SNR of their encoding."""
+    _, ctype, _ = FORMATS[fmt]
+    inits, qualities = zip(*[encode(x, fmt) for x in levels])
+    body = ',\n'.join(re.sub('(?m)^', '  ', i) for i in inits)
+    if fmt == 'float':
+        return ('const float %s[k_%s_mip_cnt][%d] = {\n%s\n};\n' % (name, prefix, WAVES_SIZE + 1, body),
+                min(qualities))
+    return 'const %s %s[k_%s_mip_cnt] = {\n%s\n};\n' % (ctype, name, prefix, body), min(qualities)
+
+
+def emit_header(waves, fmt, bank, out, mips=None, prefix=None):
+    _, ctype, size = FORMATS[fmt]
+    out.write('/*\n * Generated by tools/wavetable/wavetable.py, do not edit.\n *\n')
+    out.write(' * Format: %s, %d bytes per table, %d waves' % (fmt, size, len(waves)))
+    if mips:
+        out.write(' of %d mipmap levels.\n *\n' % len(mip_harmonics()))
+        out.write(' * Select level once per block with %s_mip_idx[note], e.g.: for %s format:\n' % (prefix, fmt))
+        if fmt == 'float':
+            out.write(' *   const float *w = wave[%s_mip_idx[params->pitch >> 8]];\n' % prefix)
+            out.write(' *   ... osc_wave_scanuf(w, phase) ...\n */\n\n')
+        else:
+            out.write(' *   const %s *w = &wave[%s_mip_idx[params->pitch >> 8]];\n' % (ctype, prefix))
+            out.write(' *   ... osc_wave_%s_scanuf(w, phase) ...\n */\n\n' % fmt)
+    else:
+        out.write('.\n */\n\n')
+    out.write('#pragma once\n\n#include "userosc.h"\n\n')
+    if mips:
+        levels = mip_harmonics()
+        out.write('#define k_%s_mip_cnt %d\n\n' % (prefix, len(levels)))
+        out.write('// Highest harmonic per level: %s\n' % ', '.join(str(h) for h in levels))
+        out.write('const uint8_t %s_mip_idx[%d] = {\n%s\n};\n\n' % (prefix, NOTES_CNT, rows(mips, '%d', 19)))
+    for name, text, quality in waves:
+        if quality != float('inf'):
+            out.write('// SNR %.1f dB\n' % quality)
+        out.write(text + '\n')
+    if bank:
+        out.write('#define k_%s_cnt %d\n\n' % (bank, len(waves)))
+        if fmt == 'float' and mips:
+            # Pointers to first level, level k of wave i is then bank[i][k]
+            out.write('const float (* const %s[k_%s_cnt])[%d] = {\n' % (bank, bank, WAVES_SIZE + 1))
+            ref = ''
+        else:
+            # With mipmaps, pointers to first level, level k of wave i is then bank[i] + k
+            out.write('const %s * const %s[k_%s_cnt] = {\n' % (ctype, bank, bank))
+            ref = '' if mips or fmt == 'float' else '&'
+        out.write(',\n'.join('  %s%s' % (ref, name) for name, _, _ in waves))
+        out.write('\n};\n')
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('inputs', nargs='+', help='single cycle WAV or text files')
+    parser.add_argument('-f', '--format', choices=sorted(FORMATS), default='s12', help='output format (default: s12)')
+    parser.add_argument('-b', '--bank', help='also emit an array of all waves with given name')
+    parser.add_argument('-m', '--mipmaps', action='store_true', help='emit band-limited tables, one per octave')
+    parser.add_argument('-n', '--no-normalize', action='store_true', help='keep DC offset and level')
+    parser.add_argument('-o', '--output', help='output file (default: stdout)')
+    args = parser.parse_args(argv)
+
+    waves = []
+    mips = None
+    prefix = args.bank or 'wavetable'
+    for path in args.inputs:
+        x = read_wave(path)
+        if not args.no_normalize:
+            x = remove_dc(x)
+        if args.mipmaps:
+            levels = mipmaps(x)
+            if not args.no_normalize:
+                # Common scale so that level does not jump when switching tables
+                peak = max(abs(v) for v in levels[0])
+                levels = [normalize(l, peak) for l in levels]
+            text, quality = emit_mipmaps(c_name(path), levels, prefix, args.format)
+            mips = mip_notes(mip_harmonics())
+        else:
+            x = resample(x)
+            if not args.no_normalize:
+                x = normalize(x)
+            text, quality = emit_wave(c_name(path), x, args.format)
+        waves.append((c_name(path), text, quality))
+
+    out = open(args.output, 'w') if args.output else sys.stdout
+    try:
+        emit_header(waves, args.format, args.bank, out, mips, prefix)
+    finally:
+        if args.output:
+            out.close()
+
+
+if __name__ == '__main__':
+    main()